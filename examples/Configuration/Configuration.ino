@@ -29,6 +29,11 @@ class TestConfig_A : public AbstractConfigParams {
         }
       }
     }
+    
+    // Defines the storage format: the parameters in this order, packed
+    void visitParams(ConfigParamVisitor &visitor) {
+      visitor.param(param1);
+    }
 
     void print() {
       AbstractConfigParams::print();
@@ -0,0 +1,101 @@
+/*
+ * Host benchmark: boot time of AbstractLog::init() versus the number of log-entry slots on the (emulated) FRAM chip.
+ *
+ * For every log size the log is filled until it has wrapped around and its head sits in the middle of the ring, then
+ * the I2C traffic of init() is measured on the mock bus (see extras/host/Wire.h) and converted into the bus time of
+ * a real board. The reference column replays the former linear scan (reading every entry up to the head, then up to the tail),
+ * the last column shows init() of a log with a checkpoint.
+ *
+ *   ./ACF_LogBoot_Bench > bench_output.txt
+ */
+#include <stdio.h>
+#include <Wire.h>
+#include <ACF_FRAM.h>
+#include <ACF_Logging.h>
+
+#define I2C_CLOCK_HZ 400000L  // fast-mode I2C
+
+class BenchLog : public AbstractLog {
+  public:
+    BenchLog(AbstractStore *store, bool checkpoint = false) : AbstractLog(store, checkpoint) { }
+
+    Timestamp logMessage(T_Message_ID id, T_Message_Param param1, T_Message_Param param2) {
+      LogData data;
+      memset(&data, 0x0, sizeof(data));
+      memcpy(data.payload, &id, sizeof(id));
+      data.payload[2] = param1;
+      data.payload[3] = param2;
+      return addLogEntry(0, &data).timestamp;
+    }
+
+    uint16_t slots() { return logEntrySlots; }
+    uint16_t head() { return logHeadIndex; }
+
+    /*
+     * The head and tail discovery as it was before the binary search.
+     */
+    void linearScan() {
+      LogEntry entry;
+      uint16_t head = 0;
+      for (uint16_t i = 0; i < logEntrySlots; i++) {
+        store->read(entryOffset(i), entry);
+        if (entry.timestamp == 0L) {
+          head = i;
+          break;
+        }
+      }
+      for (uint16_t i = 1; i < logEntrySlots; i++) {
+        store->read(entryOffset((head + i) % logEntrySlots), entry);
+        if (entry.timestamp != 0L) break;
+      }
+    }
+};
+
+/*
+ * Bus time in microseconds: 9 clock cycles per byte (8 data bits + ACK) plus start and stop condition per transaction.
+ */
+static uint32_t busMicros(uint32_t busBytes, uint32_t transactions) {
+  return (uint32_t) (((uint64_t) busBytes * 9 + transactions * 2) * 1000000L / I2C_CLOCK_HZ);
+}
+
+/*
+ * Fills a log on a fresh FRAM store beyond wrap-around, then resets the bus counters and runs init().
+ */
+static void fillAndInit(BenchLog &log) {
+  log.init();
+  for (uint32_t i = 0; i < log.slots() + log.slots() / 2; i++) {
+    log.logMessage(0, i, 0);
+  }
+  Wire.resetCounters();
+  log.init();
+}
+
+int main() {
+  static const uint16_t SLOTS[] = { 16, 64, 256, 1024, 2048, 2700 };
+  printf("AbstractLog::init() on FRAM, I2C @ %ld Hz, sizeof(LogEntry) = %u\n\n", I2C_CLOCK_HZ, (unsigned) sizeof(LogEntry));
+  printf("%8s %8s | %10s %10s %10s | %10s %10s %10s | %10s\n", "slots", "head", "init tx", "init bytes", "init [us]", "linear tx", "lin. bytes", "lin. [us]", "ckpt [us]");
+  for (uint8_t k = 0; k < sizeof(SLOTS) / sizeof(SLOTS[0]); k++) {
+    FRAMStore store = FRAMStore(sizeof(uint8_t) + sizeof(uint16_t) + SLOTS[k] * sizeof(LogEntry));
+    store.init();
+    BenchLog log = BenchLog(&store);
+    fillAndInit(log);
+    const uint32_t initTx = Wire.transactions;
+    const uint32_t initBytes = Wire.busBytes;
+
+    Wire.resetCounters();
+    log.linearScan();
+    const uint32_t linearTx = Wire.transactions;
+    const uint32_t linearBytes = Wire.busBytes;
+
+    FRAMStore checkpointStore = FRAMStore(store.size() + sizeof(LogCheckpoint));
+    BenchLog checkpointLog = BenchLog(&checkpointStore, true);
+    fillAndInit(checkpointLog);
+    const uint32_t checkpointMicros = busMicros(Wire.busBytes, Wire.transactions);
+
+    printf("%8u %8u | %10lu %10lu %10lu | %10lu %10lu %10lu | %10lu\n", log.slots(), log.head(),
+      (unsigned long) initTx, (unsigned long) initBytes, (unsigned long) busMicros(initBytes, initTx),
+      (unsigned long) linearTx, (unsigned long) linearBytes, (unsigned long) busMicros(linearBytes, linearTx),
+      (unsigned long) checkpointMicros);
+  }
+  return 0;
+}
@@ -0,0 +1,103 @@
+/*
+ * Host benchmark: dumping a full 32 KB log on the (emulated) FRAM chip over a serial line, as formatted text versus
+ * the binary export of ACF_LogExport.
+ *
+ * The text dump prints every entry with nextLogEntry() as "timestamp type payload-in-hex"; the binary export writes frames of
+ * entries as stored. The serial time assumes 10 bit times per byte (start + 8 data + stop bit), the I2C time is measured
+ * on the mock bus (see extras/host/Wire.h).
+ *
+ *   ./ACF_LogExport_Bench > bench_output.txt
+ */
+#include <stdio.h>
+#include <Wire.h>
+#include <ACF_FRAM.h>
+#include <ACF_Logging.h>
+#include <ACF_LogExport.h>
+
+#define I2C_CLOCK_HZ 400000L  // fast-mode I2C
+#define SERIAL_BAUD  115200L
+#define FRAM_SIZE    32768L   // MB85RC256V
+
+class BenchLog : public AbstractLog {
+  public:
+    BenchLog(AbstractStore *store) : AbstractLog(store) { }
+
+    Timestamp logMessage(T_Message_ID id, T_Message_Param param1, T_Message_Param param2) {
+      LogData data;
+      memset(&data, 0x0, sizeof(data));
+      memcpy(data.payload, &id, sizeof(id));
+      data.payload[2] = param1;
+      data.payload[3] = param2;
+      return addLogEntry(0, &data).timestamp;
+    }
+};
+
+/*
+ * Counts the bytes written.
+ */
+class CountingPrint : public Print {
+  public:
+    uint32_t bytes = 0;
+    size_t write(uint8_t) { bytes++; return 1; }
+    size_t write(const uint8_t *, size_t size) { bytes += size; return size; }
+};
+
+static uint32_t busMicros(uint32_t busBytes, uint32_t transactions) {
+  return (uint32_t) (((uint64_t) busBytes * 9 + transactions * 2) * 1000000L / I2C_CLOCK_HZ);
+}
+
+static uint32_t serialMillis(uint32_t bytes) {
+  return (uint32_t) ((uint64_t) bytes * 10 * 1000 / SERIAL_BAUD);
+}
+
+static void report(const char *name, uint32_t entries, CountingPrint &out) {
+  printf("%-8s %8lu %10lu %12lu %10lu %10lu\n", name, (unsigned long) entries, (unsigned long) out.bytes,
+    (unsigned long) serialMillis(out.bytes), (unsigned long) Wire.transactions,
+    (unsigned long) busMicros(Wire.busBytes, Wire.transactions) / 1000);
+}
+
+int main() {
+  FRAMStore store = FRAMStore(FRAM_SIZE);
+  store.init();
+  BenchLog log = BenchLog(&store);
+  log.init();
+  for (uint32_t i = 0; i < log.maxLogEntries(); i++) {
+    log.logMessage(0, i, 0);
+  }
+  printf("Dump of %u log entries (%ld bytes of FRAM), serial @ %ld baud, I2C @ %ld Hz\n\n", log.currentLogEntries(), FRAM_SIZE, SERIAL_BAUD, I2C_CLOCK_HZ);
+  printf("%-8s %8s %10s %12s %10s %10s\n", "format", "entries", "bytes", "serial [ms]", "i2c tx", "i2c [ms]");
+
+  CountingPrint text;
+  LogCursor cursor;
+  LogEntry e;
+  char buf[MAX_TIMESTAMP_STR_LEN];
+  uint32_t entries = 0;
+  log.readMostRecentLogEntries(cursor, 0);
+  Wire.resetCounters();
+  while (log.nextLogEntry(cursor, e)) {
+    text.print(formatTimestamp(e.timestamp, buf));
+    text.print(' ');
+    text.print(e.type);
+    for (uint8_t i = 0; i < sizeof(LogData); i++) {
+      text.print(' ');
+      text.print(e.data.payload[i], HEX);
+    }
+    text.println();
+    entries++;
+  }
+  report("text", entries, text);
+
+  CountingPrint binary;
+  log.readMostRecentLogEntries(cursor, 0);
+  Wire.resetCounters();
+  entries = exportLog(log, cursor, binary);
+  report("binary", entries, binary);
+
+  binary.bytes = 0;
+  log.readUnnotifiedLogEntries(cursor);
+  Wire.resetCounters();
+  entries = exportLog(log, cursor, binary);
+  report("binary ^", entries, binary);
+  printf("\n^ = oldest first (newest first: each block of consecutive slots is reversed in RAM)\n");
+  return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef ACF_HOST_ADAFRUIT_FRAM_I2C_H_INCLUDED
+  #define ACF_HOST_ADAFRUIT_FRAM_I2C_H_INCLUDED
+
+  #include <Wire.h>
+
+  #define MB85RC_DEFAULT_ADDRESS 0x50
+
+  /*
+   * Host stand-in for the Adafruit_FRAM_I2C library, talking to the FRAM chip of the mock I2C bus (see Wire.h).
+   */
+  class Adafruit_FRAM_I2C {
+    public:
+      bool begin(uint8_t addr = MB85RC_DEFAULT_ADDRESS) {
+        i2cAddr = addr;
+        Wire.begin();
+        Wire.beginTransmission(addr);
+        return Wire.endTransmission() == 0;
+      }
+
+      void write8(uint16_t framAddr, uint8_t value) {
+        Wire.beginTransmission(i2cAddr);
+        Wire.write(framAddr >> 8);
+        Wire.write(framAddr & 0xFF);
+        Wire.write(value);
+        Wire.endTransmission();
+      }
+
+      uint8_t read8(uint16_t framAddr) {
+        Wire.beginTransmission(i2cAddr);
+        Wire.write(framAddr >> 8);
+        Wire.write(framAddr & 0xFF);
+        Wire.endTransmission();
+        Wire.requestFrom(i2cAddr, (uint8_t) 1);
+        return Wire.read();
+      }
+
+    private:
+      uint8_t i2cAddr = MB85RC_DEFAULT_ADDRESS;
+  };
+
+#endif
@@ -0,0 +1,53 @@
+#include <Arduino.h>
+#include <stdio.h>
+#include <chrono>
+
+static uint64_t delayedMillis = 0;
+
+static uint64_t elapsedMicros() {
+  static const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+uint32_t millis() {
+  return (uint32_t) (elapsedMicros() / 1000 + delayedMillis);
+}
+
+uint32_t micros() {
+  return (uint32_t) (elapsedMicros() + delayedMillis * 1000);
+}
+
+void delay(uint32_t ms) {
+  delayedMillis += ms;
+}
+
+size_t Print::write(const uint8_t *buf, size_t size) {
+  size_t n = 0;
+  while (size--) n += write(*buf++);
+  return n;
+}
+
+size_t Print::print(long n, int base) {
+  if (base != DEC) return print((unsigned long) n, base);
+  char buf[24];
+  snprintf(buf, sizeof(buf), "%ld", n);
+  return write(buf);
+}
+
+size_t Print::print(unsigned long n, int base) {
+  char buf[24];
+  snprintf(buf, sizeof(buf), base == HEX ? "%lX" : "%lu", n);
+  return write(buf);
+}
+
+size_t Print::print(double n, int digits) {
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", digits, n);
+  return write(buf);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  return putchar(c) == EOF ? 0 : 1;
+}
+
+HardwareSerial Serial;
@@ -0,0 +1,87 @@
+#ifndef ACF_HOST_ARDUINO_H_INCLUDED
+  #define ACF_HOST_ARDUINO_H_INCLUDED
+
+  /*
+   * Thin host (workstation) stand-in for the Arduino core: just enough of the API used by this library and its tests.
+   * millis() counts from program start; delay() does not sleep but advances millis() instantly.
+   */
+
+  #include <stdint.h>
+  #include <stddef.h>
+  #include <stdlib.h>
+  #include <string.h>
+
+  typedef bool boolean;
+  typedef uint8_t byte;
+
+  #define HIGH 0x1
+  #define LOW  0x0
+  #define INPUT  0x0
+  #define OUTPUT 0x1
+  #define LED_BUILTIN 13
+
+  #define DEC 10
+  #define HEX 16
+
+  #define PROGMEM
+  #define pgm_read_byte(addr)  (*(const uint8_t *)(addr))
+  #define pgm_read_word(addr)  (*(const uint16_t *)(addr))
+  #define pgm_read_dword(addr) (*(const uint32_t *)(addr))
+  #define pgm_read_ptr(addr)   (*(void * const *)(addr))
+  #define memcpy_P memcpy
+
+  class __FlashStringHelper;
+  #define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+  uint32_t millis();
+  uint32_t micros();
+  void delay(uint32_t ms);
+
+  inline void pinMode(uint8_t, uint8_t) { }
+  inline void digitalWrite(uint8_t, uint8_t) { }
+
+  inline void noInterrupts() { }
+  inline void interrupts() { }
+
+  class Print {
+    public:
+      virtual ~Print() { }
+      virtual size_t write(uint8_t c) = 0;
+      virtual size_t write(const uint8_t *buf, size_t size);
+      size_t write(const char *str) { return write((const uint8_t *) str, strlen(str)); }
+
+      size_t print(const __FlashStringHelper *str) { return write((const char *) str); }
+      size_t print(const char *str) { return write(str); }
+      size_t print(char c) { return write((uint8_t) c); }
+      size_t print(unsigned char n, int base = DEC) { return print((unsigned long) n, base); }
+      size_t print(int n, int base = DEC) { return print((long) n, base); }
+      size_t print(unsigned int n, int base = DEC) { return print((unsigned long) n, base); }
+      size_t print(long n, int base = DEC);
+      size_t print(unsigned long n, int base = DEC);
+      size_t print(long long n, int base = DEC) { return print((long) n, base); }
+      size_t print(unsigned long long n, int base = DEC) { return print((unsigned long) n, base); }
+      size_t print(double n, int digits = 2);
+
+      size_t println() { return write('\n'); }
+      template<typename T> size_t println(T value) { size_t n = print(value); return n + println(); }
+      template<typename T> size_t println(T value, int format) { size_t n = print(value, format); return n + println(); }
+  };
+
+  /*
+   * Writes to stdout.
+   */
+  class HardwareSerial : public Print {
+    public:
+      void begin(unsigned long) { }
+      operator bool() { return true; }
+      size_t write(uint8_t c);
+      using Print::write;
+  };
+
+  extern HardwareSerial Serial;
+
+  // implemented by the sketch:
+  void setup();
+  void loop();
+
+#endif
@@ -0,0 +1,56 @@
+#include <ArduinoUnit.h>
+#include <fnmatch.h>
+#include <stdio.h>
+
+Test *Test::first = NULL;
+Test *Test::current = NULL;
+uint8_t Test::min_verbosity = 0;
+
+Test::Test(const char *name) {
+  this->name = name;
+  // keep the tests sorted by name:
+  Test **t = &first;
+  while (*t != NULL && strcmp((*t)->name, name) < 0) t = &(*t)->next;
+  next = *t;
+  *t = this;
+}
+
+void Test::include(const char *pattern) {
+  for (Test *t = first; t != NULL; t = t->next) {
+    if (fnmatch(pattern, t->name, 0) == 0) t->excluded = false;
+  }
+}
+
+void Test::exclude(const char *pattern) {
+  for (Test *t = first; t != NULL; t = t->next) {
+    if (fnmatch(pattern, t->name, 0) == 0) t->excluded = true;
+  }
+}
+
+void Test::run() {
+  const char *env = getenv("ACF_TEST_EXCLUDE");
+  if (env != NULL) {
+    char patterns[256];
+    strncpy(patterns, env, sizeof(patterns) - 1);
+    patterns[sizeof(patterns) - 1] = '\0';
+    for (char *p = strtok(patterns, " ,"); p != NULL; p = strtok(NULL, " ,")) {
+      exclude(p);
+    }
+  }
+
+  uint16_t passed = 0, failed = 0, skipped = 0;
+  for (Test *t = first; t != NULL; t = t->next) {
+    if (t->excluded) {
+      skipped++;
+      printf("Test %s skipped.\n", t->name);
+      continue;
+    }
+    current = t;
+    t->once();
+    printf("Test %s %s.\n", t->name, t->failed ? "failed" : "passed");
+    if (t->failed) failed++; else passed++;
+  }
+  printf("Test summary: %u passed, %u failed, and %u skipped, out of %u test(s).\n", passed, failed, skipped, passed + failed + skipped);
+  fflush(stdout);
+  exit(failed == 0 ? 0 : 1);
+}
@@ -0,0 +1,62 @@
+#ifndef ACF_HOST_ARDUINOUNIT_H_INCLUDED
+  #define ACF_HOST_ARDUINOUNIT_H_INCLUDED
+
+  #include <Arduino.h>
+
+  /*
+   * Host stand-in for the subset of ArduinoUnit used by the test sketches.
+   *
+   * Test::run() runs all the tests in alphabetical order, prints a summary and terminates the program with exit code 0 (all tests
+   * passed) or 1. Tests can be excluded through the environment variable ACF_TEST_EXCLUDE (space-separated list of name patterns).
+   */
+  #define TEST_VERBOSITY_ALL 0x3F
+
+  class Test {
+    public:
+      Test(const char *name);
+      virtual ~Test() { }
+
+      /* Test body. */
+      virtual void once() = 0;
+
+      const char *name;
+      bool failed = false;
+
+      static void run();
+      static void include(const char *pattern);
+      static void exclude(const char *pattern);
+      static uint8_t min_verbosity;
+
+      /* The test being run. */
+      static Test *current;
+
+    private:
+      Test *next;
+      bool excluded = false;
+      static Test *first;
+  };
+
+  #define test(name) \
+    class test_##name : public Test { public: test_##name() : Test(#name) { } void once(); } test_##name##_instance; \
+    void test_##name::once()
+
+  #define ACF_UNIT_FAIL(what) do { \
+      Serial.print(F("Assertion failed: ")); Serial.print(F(what)); \
+      Serial.print(F(", file ")); Serial.print(F(__FILE__)); Serial.print(F(", line ")); Serial.println((long) __LINE__); \
+      Test::current->failed = true; \
+      return; \
+    } while (0)
+
+  #define ACF_UNIT_ASSERT_OP(a, op, b) do { if (!((a) op (b))) ACF_UNIT_FAIL("(" #a ") " #op " (" #b ")"); } while (0)
+
+  #define assertTrue(a)           do { if (!(a)) ACF_UNIT_FAIL("(" #a ") is true"); } while (0)
+  #define assertFalse(a)          do { if (a) ACF_UNIT_FAIL("(" #a ") is false"); } while (0)
+  #define assertEqual(a, b)       ACF_UNIT_ASSERT_OP(a, ==, b)
+  #define assertNotEqual(a, b)    ACF_UNIT_ASSERT_OP(a, !=, b)
+  #define assertLess(a, b)        ACF_UNIT_ASSERT_OP(a, <,  b)
+  #define assertMore(a, b)        ACF_UNIT_ASSERT_OP(a, >,  b)
+  #define assertLessOrEqual(a, b) ACF_UNIT_ASSERT_OP(a, <=, b)
+  #define assertMoreOrEqual(a, b) ACF_UNIT_ASSERT_OP(a, >=, b)
+  #define fail()                  ACF_UNIT_FAIL("fail()")
+
+#endif
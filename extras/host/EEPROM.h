@@ -0,0 +1,29 @@
+#ifndef ACF_HOST_EEPROM_H_INCLUDED
+  #define ACF_HOST_EEPROM_H_INCLUDED
+
+  #include <Arduino.h>
+
+  /*
+   * Host stand-in for the Arduino EEPROM library: 4 KB of RAM (like an ATmega2560), all cells 0x0 at program start.
+   */
+  #define E2END 0xFFF
+
+  class EEPROMClass {
+    public:
+      uint8_t read(int idx) { return cells[idx]; }
+      void write(int idx, uint8_t val) { cells[idx] = val; writes++; }
+      void update(int idx, uint8_t val) { if (cells[idx] != val) write(idx, val); }
+      uint16_t length() { return E2END + 1; }
+
+      /*
+       * Number of cell writes since program start (host only).
+       */
+      uint32_t writes = 0;
+
+    private:
+      uint8_t cells[E2END + 1];
+  };
+
+  extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,62 @@
+#include <Wire.h>
+#include <EEPROM.h>
+
+TwoWire Wire;
+EEPROMClass EEPROM;
+
+void TwoWire::beginTransmission(uint8_t addr) {
+  txAddress = addr;
+  txLength = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (txLength >= BUFFER_LENGTH) {
+    dropped++;
+    return 0;
+  }
+  txBuffer[txLength++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t quantity) {
+  size_t n = 0;
+  while (quantity--) n += write(*data++);
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(bool) {
+  transactions++;
+  busBytes += 1 + txLength;
+  if (txAddress != FRAM_ADDRESS) return 2;  // NACK on address
+  if (txLength >= 2) {
+    if (txLength - 2 > maxData) maxData = txLength - 2;
+    // memory address (MSB first), followed by the data of a sequential write:
+    framPointer = ((txBuffer[0] << 8) | txBuffer[1]) % FRAM_SIZE;
+    for (uint8_t i = 2; i < txLength; i++) {
+      fram[framPointer] = txBuffer[i];
+      framPointer = (framPointer + 1) % FRAM_SIZE;
+    }
+  }
+  return 0;
+}
+
+uint8_t TwoWire::requestFrom(uint8_t addr, uint8_t quantity, bool) {
+  transactions++;
+  busBytes += 1;
+  rxIndex = 0;
+  rxLength = 0;
+  if (addr != FRAM_ADDRESS) return 0;
+  if (quantity > BUFFER_LENGTH) {
+    dropped += quantity - BUFFER_LENGTH;
+    quantity = BUFFER_LENGTH;
+  }
+  if (quantity > maxData) maxData = quantity;
+  // sequential read from the current memory address:
+  for (uint8_t i = 0; i < quantity; i++) {
+    rxBuffer[i] = fram[framPointer];
+    framPointer = (framPointer + 1) % FRAM_SIZE;
+  }
+  rxLength = quantity;
+  busBytes += quantity;
+  return quantity;
+}
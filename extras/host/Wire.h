@@ -0,0 +1,53 @@
+#ifndef ACF_HOST_WIRE_H_INCLUDED
+  #define ACF_HOST_WIRE_H_INCLUDED
+
+  #include <Arduino.h>
+
+  #define BUFFER_LENGTH 32
+
+  /*
+   * Host stand-in for the Arduino Wire library: a mock I2C bus with a 32 KB MB85RC FRAM chip (MB85RC256V) attached at address 0x50.
+   * The bus counts transactions and bytes (including the device-address byte of each transaction) so the bus traffic of the
+   * FRAM store can be measured on the host.
+   */
+  class TwoWire {
+    public:
+      static const uint8_t  FRAM_ADDRESS = 0x50;
+      static const uint16_t FRAM_SIZE = 0x8000;
+
+      void begin() { }
+      void beginTransmission(uint8_t addr);
+      size_t write(uint8_t data);
+      size_t write(const uint8_t *data, size_t quantity);
+      uint8_t endTransmission(bool sendStop = true);
+      uint8_t requestFrom(uint8_t addr, uint8_t quantity, bool sendStop = true);
+      int available() { return rxLength - rxIndex; }
+      int read() { return rxIndex < rxLength ? rxBuffer[rxIndex++] : -1; }
+
+      /*
+       * Bus statistics (host only).
+       */
+      uint32_t transactions = 0;
+      uint32_t busBytes = 0;
+      uint8_t  maxData = 0;   // largest number of data bytes of a transaction (excluding device and memory address)
+      uint32_t dropped = 0;   // bytes not transmitted because the Wire buffer was full
+      void resetCounters() { transactions = 0; busBytes = 0; maxData = 0; dropped = 0; }
+
+      /*
+       * Contents of the emulated FRAM chip (host only).
+       */
+      uint8_t fram[FRAM_SIZE];
+
+    private:
+      uint8_t  txAddress = 0;
+      uint8_t  txLength = 0;
+      uint8_t  txBuffer[BUFFER_LENGTH];
+      uint8_t  rxIndex = 0;
+      uint8_t  rxLength = 0;
+      uint8_t  rxBuffer[BUFFER_LENGTH];
+      uint16_t framPointer = 0;
+  };
+
+  extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,13 @@
+#include <Arduino.h>
+
+/*
+ * Entry point of a sketch built for the host, like the main() of the Arduino core.
+ */
+int main(int argc, char **argv) {
+  (void) argc;
+  (void) argv;
+  setup();
+  for (;;) {
+    loop();
+  }
+}
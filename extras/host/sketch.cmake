@@ -0,0 +1,37 @@
+# Converts an Arduino sketch (.ino) into a C++ translation unit the way the Arduino IDE does:
+# includes <Arduino.h> and inserts prototypes of the sketch's functions before the first function definition.
+#
+# Usage: cmake -DINO=<sketch.ino> -DOUT=<sketch.cpp> -P sketch.cmake
+
+file(READ "${INO}" content)
+
+set(definition "\n(void|bool|boolean|byte|char|int|long|float|double|u?int[0-9]+_t)[ \t]+[A-Za-z_][A-Za-z_0-9]*[ \t]*\\([^)\n]*\\)[ \t]*{")
+string(REGEX MATCHALL "${definition}" definitions "${content}")
+
+set(prototypes "")
+set(position -1)
+foreach(def IN LISTS definitions)
+  string(REGEX REPLACE "^\n" "" def "${def}")
+  string(REGEX REPLACE "[ \t]*{$" ";" prototype "${def}")
+  if(NOT prototype MATCHES "^(void|int) (setup|loop|main)\\(")
+    string(APPEND prototypes "${prototype}\n")
+  endif()
+  if(position EQUAL -1)
+    string(FIND "${content}" "${def}" position)
+  endif()
+endforeach()
+
+if(position EQUAL -1)
+  set(head "${content}")
+  set(tail "")
+else()
+  string(SUBSTRING "${content}" 0 ${position} head)
+  string(SUBSTRING "${content}" ${position} -1 tail)
+endif()
+string(REGEX MATCHALL "\n" newlines "${head}")
+list(LENGTH newlines line)
+math(EXPR line "${line} + 1")
+
+file(WRITE "${OUT}.tmp" "#include <Arduino.h>\n#line 1 \"${INO}\"\n${head}${prototypes}#line ${line} \"${INO}\"\n${tail}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E copy_if_different "${OUT}.tmp" "${OUT}")
+file(REMOVE "${OUT}.tmp")
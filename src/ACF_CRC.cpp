@@ -0,0 +1,11 @@
+#include <ACF_CRC.h>
+
+uint16_t crc16(const uint8_t *data, uint16_t len, uint16_t crc) {
+  for (uint16_t i = 0; i < len; i++) {
+    crc ^= (uint16_t) data[i] << 8;
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
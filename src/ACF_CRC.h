@@ -0,0 +1,15 @@
+#ifndef ACF_CRC_H_INCLUDED
+  #define ACF_CRC_H_INCLUDED
+
+  #include <Arduino.h>
+
+  #define CRC16_INIT 0xFFFF
+
+  /*
+   * CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF) over len bytes, computed bitwise (no lookup table in RAM or flash).
+   *
+   * Pass the result of a previous call as crc to continue a checksum over several blocks.
+   */
+  uint16_t crc16(const uint8_t *data, uint16_t len, uint16_t crc = CRC16_INIT);
+
+#endif
@@ -0,0 +1,195 @@
+#include <ACF_CachedStore.h>
+
+// #define DEBUG_CACHE
+
+CachedStore::CachedStore(AbstractStore *store, const uint8_t numPages, const uint16_t pageSize, const CacheReplacement replacement) : AbstractStore(0, store->size()) {
+  this->store = store;
+  this->numPages = numPages;
+  this->pageSize = pageSize;
+  this->replacement = replacement;
+  pages = (CachePage *) malloc(numPages * sizeof(CachePage));
+  memory = (uint8_t *) malloc(numPages * pageSize);
+  for (uint8_t i = 0; i < numPages; i++) {
+    pages[i].valid = false;
+    pages[i].dirtyFrom = 0;
+    pages[i].dirtyTo = 0;
+    pages[i].lastUsed = 0;
+    pages[i].data = memory + i * pageSize;
+  }
+}
+
+CachedStore::~CachedStore() {
+  flush();
+  free(memory);
+  free(pages);
+}
+
+void CachedStore::clear() {
+  #ifdef DEBUG_CACHE
+    Serial.println(F("DEBUG_CACHE clear()"));
+  #endif
+  for (uint8_t i = 0; i < numPages; i++) {
+    pages[i].valid = false;
+    pages[i].dirtyFrom = 0;
+    pages[i].dirtyTo = 0;
+  }
+  store->clear();
+}
+
+void CachedStore::resetCounters() {
+  hitCount = 0;
+  missCount = 0;
+  flushCount = 0;
+}
+
+uint16_t CachedStore::pageLength(CachePage *p) {
+  const uint32_t remaining = sizeBytes - p->base;
+  return remaining < pageSize ? remaining : pageSize;
+}
+
+CachePage *CachedStore::page(uint32_t idx) {
+  const uint32_t base = idx - idx % pageSize;
+  CachePage *p;
+  if (replacement == CacheReplacement::DIRECT_MAPPED) {
+    p = &pages[(base / pageSize) % numPages];
+    if (p->valid && p->base == base) {
+      hitCount++;
+      return p;
+    }
+  } else {
+    p = NULL;
+    for (uint8_t i = 0; i < numPages; i++) {
+      CachePage *candidate = &pages[i];
+      if (candidate->valid && candidate->base == base) {
+        hitCount++;
+        candidate->lastUsed = ++tick;
+        return candidate;
+      }
+      // victim: an invalid page, else the least-recently used one
+      if (p == NULL || (p->valid && (! candidate->valid || candidate->lastUsed < p->lastUsed))) {
+        p = candidate;
+      }
+    }
+    p->lastUsed = ++tick;
+  }
+
+  missCount++;
+  if (p->valid) {
+    writeBack(p);
+  }
+  p->base = base;
+  p->valid = true;
+  p->dirtyFrom = 0;
+  p->dirtyTo = 0;
+  store->readBlock(base, p->data, pageLength(p));
+  #ifdef DEBUG_CACHE
+    Serial.print(F("DEBUG_CACHE load  ["));
+    Serial.print(base);
+    Serial.println(']');
+  #endif
+  return p;
+}
+
+void CachedStore::markDirty(CachePage *p, uint16_t from, uint16_t to) {
+  if (p->dirtyFrom == p->dirtyTo) {
+    p->dirtyFrom = from;
+    p->dirtyTo = to;
+  } else {
+    if (from < p->dirtyFrom) p->dirtyFrom = from;
+    if (to > p->dirtyTo) p->dirtyTo = to;
+  }
+}
+
+void CachedStore::writeBack(CachePage *p) {
+  if (p->dirtyFrom == p->dirtyTo) return;
+  #ifdef DEBUG_CACHE
+    Serial.print(F("DEBUG_CACHE flush ["));
+    Serial.print(p->base + p->dirtyFrom);
+    Serial.print(F(".."));
+    Serial.print(p->base + p->dirtyTo - 1);
+    Serial.println(']');
+  #endif
+  if (store->expiringMedia()) {
+    store->updateBlock(p->base + p->dirtyFrom, p->data + p->dirtyFrom, p->dirtyTo - p->dirtyFrom);
+  } else {
+    store->writeBlock(p->base + p->dirtyFrom, p->data + p->dirtyFrom, p->dirtyTo - p->dirtyFrom);
+  }
+  p->dirtyFrom = 0;
+  p->dirtyTo = 0;
+  flushCount++;
+}
+
+void CachedStore::flush() {
+  for (uint8_t i = 0; i < numPages; i++) {
+    if (pages[i].valid) {
+      writeBack(&pages[i]);
+    }
+  }
+}
+
+uint8_t CachedStore::read8(uint32_t idx) {
+  CachePage *p = page(idx);
+  return p->data[idx - p->base];
+}
+
+void CachedStore::write8(uint32_t idx, uint8_t val) {
+  CachePage *p = page(idx);
+  const uint16_t i = idx - p->base;
+  p->data[i] = val;
+  markDirty(p, i, i + 1);
+}
+
+bool CachedStore::update8(uint32_t idx, uint8_t val) {
+  CachePage *p = page(idx);
+  const uint16_t i = idx - p->base;
+  if (p->data[i] == val) return false;
+  p->data[i] = val;
+  markDirty(p, i, i + 1);
+  return true;
+}
+
+void CachedStore::readBlock(uint32_t idx, uint8_t *buf, uint32_t len) {
+  while (len > 0) {
+    CachePage *p = page(idx);
+    const uint16_t i = idx - p->base;
+    const uint32_t available = pageLength(p) - i;
+    const uint16_t n = len < available ? len : available;
+    memcpy(buf, p->data + i, n);
+    buf += n;
+    idx += n;
+    len -= n;
+  }
+}
+
+void CachedStore::writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  while (len > 0) {
+    CachePage *p = page(idx);
+    const uint16_t i = idx - p->base;
+    const uint32_t available = pageLength(p) - i;
+    const uint16_t n = len < available ? len : available;
+    memcpy(p->data + i, buf, n);
+    markDirty(p, i, i + n);
+    buf += n;
+    idx += n;
+    len -= n;
+  }
+}
+
+bool CachedStore::updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  bool updated = false;
+  while (len > 0) {
+    CachePage *p = page(idx);
+    const uint16_t i = idx - p->base;
+    const uint32_t available = pageLength(p) - i;
+    const uint16_t n = len < available ? len : available;
+    if (memcmp(p->data + i, buf, n) != 0) {
+      memcpy(p->data + i, buf, n);
+      markDirty(p, i, i + n);
+      updated = true;
+    }
+    buf += n;
+    idx += n;
+    len -= n;
+  }
+  return updated;
+}
@@ -0,0 +1,138 @@
+#ifndef ACF_CACHED_STORE_H_INCLUDED
+  #define ACF_CACHED_STORE_H_INCLUDED
+
+  #include <ACF_Store.h>
+
+  /*
+   * Strategy to pick the cache page that receives a store page which is not cached yet.
+   */
+  enum class CacheReplacement {
+    LRU = 0,           // evict the least-recently used cache page
+    DIRECT_MAPPED = 1  // every store page has exactly one cache page: (store page number) modulo (number of cache pages)
+  };
+
+  /*
+   * A RAM copy of one page of the underlying store.
+   */
+  struct CachePage {
+    /*
+     * Store offset of the first byte of the cached page.
+     */
+    uint32_t base;
+    /*
+     * The values in this struct are defined only if valid == true.
+     */
+    boolean valid;
+    /*
+     * Range [dirtyFrom .. dirtyTo) relative to base that has been written since the page was loaded or flushed; empty if dirtyFrom == dirtyTo.
+     */
+    uint16_t dirtyFrom;
+    uint16_t dirtyTo;
+    /*
+     * Access tick of the most recent read or write (LRU replacement only).
+     */
+    uint32_t lastUsed;
+    /*
+     * The cached bytes.
+     */
+    uint8_t *data;
+  };
+
+  /*
+   * Write-back page cache wrapping any other AbstractStore (decorator). Reads and writes of neighbouring bytes are served from a small
+   * number of pages kept in RAM and only reach the underlying store when a dirty page is evicted or when flush() is invoked.<p>
+   *
+   * For expiring media (see AbstractStore::expiringMedia(), e.g. EEPROM) dirty pages are written back using updateBlock(), so only the bytes
+   * that actually changed are written to the cells; for non-expiring media the dirty range is written using writeBlock().
+   *
+   * Important: invoke flush() before the board may be reset or powered down, e.g. after a log entry was added or the configuration was saved.
+   */
+  class CachedStore : public AbstractStore {
+    public:
+
+      /*
+       * @param store the underlying store; cannot be null. The cached store covers the full size of this store.
+       * @param numPages number of pages kept in RAM (> 0)
+       * @param pageSize number of bytes per page (> 0); the RAM consumption is numPages * (pageSize + sizeof(CachePage))
+       * @param replacement strategy to pick the page to be evicted
+       */
+      CachedStore(AbstractStore *store, const uint8_t numPages, const uint16_t pageSize, const CacheReplacement replacement = CacheReplacement::LRU);
+      ~CachedStore();
+
+      /*
+       * Same as the underlying store.
+       */
+      bool expiringMedia() { return store->expiringMedia(); }
+
+      /*
+       * Clears the underlying store and discards all cached pages (without writing them back).
+       */
+      void clear();
+
+      uint8_t read8(uint32_t idx);
+      void write8(uint32_t idx, uint8_t val);
+      bool update8(uint32_t idx, uint8_t val);
+      void readBlock(uint32_t idx, uint8_t *buf, uint32_t len);
+      void writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+      bool updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+
+      /*
+       * Writes all dirty pages back to the underlying store. The pages remain cached.
+       */
+      void flush();
+
+      /*
+       * Number of page lookups that found the page in the cache.
+       */
+      uint32_t hits() { return hitCount; }
+
+      /*
+       * Number of page lookups that had to load the page from the underlying store.
+       */
+      uint32_t misses() { return missCount; }
+
+      /*
+       * Number of dirty pages written back to the underlying store (by flush() or by eviction).
+       */
+      uint32_t flushes() { return flushCount; }
+
+      /*
+       * Resets hits(), misses() and flushes() to 0.
+       */
+      void resetCounters();
+
+    protected:
+      AbstractStore *store;
+      uint8_t numPages;
+      uint16_t pageSize;
+      CacheReplacement replacement;
+      CachePage *pages;
+      uint8_t *memory;
+
+      uint32_t tick = 0;
+      uint32_t hitCount = 0;
+      uint32_t missCount = 0;
+      uint32_t flushCount = 0;
+
+      /*
+       * Returns the cache page holding the store byte at idx, loading it from the underlying store (and evicting another page) if required.
+       */
+      CachePage *page(uint32_t idx);
+
+      /*
+       * Number of valid bytes of the page (the last page of the store can be shorter than pageSize).
+       */
+      uint16_t pageLength(CachePage *p);
+
+      /*
+       * Writes the dirty range of the page back to the underlying store.
+       */
+      void writeBack(CachePage *p);
+
+      /*
+       * Extends the dirty range of the page by [from .. to).
+       */
+      void markDirty(CachePage *p, uint16_t from, uint16_t to);
+  };
+
+#endif
@@ -0,0 +1,18 @@
+#include <ACF_Clock.h>
+
+static ArduinoClock arduinoClock;
+
+
+TimeMillis64 ArduinoClock::millis64() {
+  TimeMillis ms = millis();
+  if (ms < lastMillis) {
+    overflows++;
+  }
+  lastMillis = ms;
+  return ((TimeMillis64) overflows << 32) | ms;
+}
+
+
+Clock *systemClock() {
+  return &arduinoClock;
+}
@@ -0,0 +1,73 @@
+#ifndef ACF_CLOCK_H_INCLUDED
+  #define ACF_CLOCK_H_INCLUDED
+  
+  #include <Arduino.h>
+  #include <ACF_Types.h>
+
+  /*
+   * Milliseconds since board reset that do not overflow (2^64 ms = 584 million years).
+   */
+  typedef uint64_t TimeMillis64;
+
+  /*
+   * Source of time for LogTime and AbstractStateAutomaton. Replacing the clock enables running months of (simulated) time
+   * within seconds, e.g. in unit tests on the host, see FakeClock.
+   */
+  class Clock {
+    public:
+      
+      /*
+       * Returns the milliseconds since board reset.
+       */
+      virtual TimeMillis64 millis64() = 0;
+  };
+
+  
+  /*
+   * Extends Arduino millis() to 64 bits by counting its overflows.
+   * Note: millis64() must be called at least every 49.7 days for an overflow to be detected; LogTime and AbstractStateAutomaton
+   *       call it at every timestamp and every evaluation.
+   */
+  class ArduinoClock : public Clock {
+    public:
+      TimeMillis64 millis64();
+      
+    protected:
+      /*
+       * The value of millis() at the last call of millis64(), and the number of millis() overflows so far.
+       */
+      TimeMillis lastMillis = 0L;
+      uint32_t overflows = 0L;
+  };
+
+  
+  /*
+   * Clock that only moves when told so.
+   */
+  class FakeClock : public Clock {
+    public:
+      FakeClock(TimeMillis64 start = 0) { now = start; }
+      
+      TimeMillis64 millis64() { return now; }
+      
+      /*
+       * Sets the time.
+       */
+      void set(TimeMillis64 ms) { now = ms; }
+      
+      /*
+       * Moves the time forward.
+       */
+      void advance(TimeMillis64 ms) { now += ms; }
+      
+    protected:
+      TimeMillis64 now;
+  };
+
+  
+  /*
+   * Returns the clock used unless a different one is set, an ArduinoClock.
+   */
+  Clock *systemClock();
+
+#endif
@@ -1,4 +1,7 @@
 #include <ACF_Configuration.h>
+#include <ACF_CRC.h>
+#include <ACF_Logging.h>
+#include <stddef.h>
 
 //#define DEBUG_CONFIG
 
@@ -8,6 +11,7 @@
  * very first time *cannot be assumed to be 0x0* !!
  */
 const uint8_t MAGIC_NUMBER = 123;
+const uint8_t ATOMIC_MAGIC_NUMBER = 124;  // slot header of the atomic layout
 
 #define MAGIC_NUMBER_SIZE sizeof(uint8_t)
 #define VERSION_NUMBER_SIZE sizeof(uint8_t)
@@ -15,6 +19,8 @@ const uint8_t MAGIC_NUMBER = 123;
 
 #if defined(ARDUINO_SAMD_ZERO) || defined(ARDUINO_SAMD_MKR1000)
   #define POINTER_SIZE sizeof(uint32_t)
+#elif !defined(ARDUINO)
+  #define POINTER_SIZE sizeof(void *)  // host build
 #else
   #define POINTER_SIZE sizeof(uint16_t)
 #endif
@@ -29,21 +35,210 @@ const uint8_t MAGIC_NUMBER = 123;
  */
 #define STORE_PTR_SIZE POINTER_SIZE
 /*
- * This is where the actual configuration params starts in RAM (byte offset):
+ * Pointer to the shadow copy:
  */
-#define RAM_PARAM_OFFSET (SUPERCLASS_PTR_SIZE + STORE_PTR_SIZE + VERSION_NUMBER_SIZE)
+#define SHADOW_PTR_SIZE POINTER_SIZE
+/*
+ * Atomic flag, active slot and sequence number:
+ */
+#define ATOMIC_STATE_SIZE (sizeof(bool) + sizeof(uint8_t) + sizeof(uint16_t))
+/*
+ * This is where the actual configuration params starts in RAM (byte offset), legacy format only:
+ */
+#define RAM_PARAM_OFFSET (SUPERCLASS_PTR_SIZE + STORE_PTR_SIZE + SHADOW_PTR_SIZE + ATOMIC_STATE_SIZE + VERSION_NUMBER_SIZE)
+/*
+ * Atomic layout: the parameters follow the slot header; the CRC covers the header fields from the version up to the length.
+ */
+#define SLOT_HEADER_SIZE sizeof(ConfigSlotHeader)
+#define SLOT_CRC_FIELDS_SIZE (offsetof(ConfigSlotHeader, crc) - offsetof(ConfigSlotHeader, version))
+#define SLOT_CRC_CHUNK 16
+/*
+ * Changed ranges separated by at most this many unchanged bytes are written as one block (non-expiring media only):
+ */
+#define SAVE_MERGE_GAP 4
+
+
+/*
+ * Sums up the sizes of the parameters.
+ */
+class ParamSizeVisitor : public ConfigParamVisitor {
+  public:
+    uint16_t size = 0;
+    void bytes(uint8_t *, uint16_t len) {
+      size += len;
+    }
+};
+
+/*
+ * Reads the parameters from the store; parameters beyond the given length of the stored values are set to 0x0.
+ */
+class ParamReadVisitor : public ConfigParamVisitor {
+  public:
+    ParamReadVisitor(AbstractStore *store, uint16_t offset, uint16_t length, uint8_t *shadow) {
+      this->store = store;
+      this->offset = offset;
+      this->length = length;
+      this->shadow = shadow;
+    }
+    void bytes(uint8_t *data, uint16_t len) {
+      const uint16_t stored = pos >= length ? 0 : (length - pos < len ? length - pos : len);
+      store->readBlock(offset + pos, data, stored);
+      memset(data + stored, 0x0, len - stored);
+      if (shadow != NULL) memcpy(shadow + pos, data, len);
+      pos += len;
+    }
+  protected:
+    AbstractStore *store;
+    uint16_t offset;
+    uint16_t length;
+    uint8_t *shadow;
+    uint16_t pos = 0;
+};
+
+/*
+ * Writes all parameters to the store.
+ */
+class ParamWriteVisitor : public ConfigParamVisitor {
+  public:
+    ParamWriteVisitor(AbstractStore *store, uint16_t offset, boolean update, uint8_t *shadow) {
+      this->store = store;
+      this->offset = offset;
+      this->update = update;
+      this->shadow = shadow;
+    }
+    void bytes(uint8_t *data, uint16_t len) {
+      if (update) {
+        store->updateBlock(offset + pos, data, len);
+      } else {
+        store->writeBlock(offset + pos, data, len);
+      }
+      if (shadow != NULL) memcpy(shadow + pos, data, len);
+      pos += len;
+    }
+  protected:
+    AbstractStore *store;
+    uint16_t offset;
+    boolean update;
+    uint8_t *shadow;
+    uint16_t pos = 0;
+};
+
+/*
+ * Writes the parameter bytes that differ from the shadow copy: changed bytes are first copied to the (packed) shadow,
+ * then written from there, so that changed ranges spanning several parameters are written as one block.
+ */
+class ParamDiffVisitor : public ConfigParamVisitor {
+  public:
+    ParamDiffVisitor(AbstractStore *store, uint16_t offset, uint8_t *shadow, uint16_t mergeGap) {
+      this->store = store;
+      this->offset = offset;
+      this->shadow = shadow;
+      this->mergeGap = mergeGap;
+    }
+    void bytes(uint8_t *data, uint16_t len) {
+      for (uint16_t i = 0; i < len; i++, pos++) {
+        if (data[i] == shadow[pos]) continue;
+        shadow[pos] = data[i];
+        if (end == 0 || pos - end > mergeGap) {
+          flush();
+          start = pos;
+        }
+        end = pos + 1;
+      }
+    }
+    /*
+     * Writes the pending range.
+     */
+    void flush() {
+      if (end == 0) return;
+      #ifdef DEBUG_CONFIG
+        Serial.print(F("DEBUG_CONFIG Save bytes "));
+        Serial.print(start);
+        Serial.print(F(".."));
+        Serial.println(end - 1);
+      #endif
+      store->writeBlock(offset + start, shadow + start, end - start);
+      end = 0;
+    }
+  protected:
+    AbstractStore *store;
+    uint16_t offset;
+    uint8_t *shadow;
+    uint16_t mergeGap;
+    uint16_t pos = 0;
+    uint16_t start = 0;
+    uint16_t end = 0;  // exclusive; 0 = no pending range
+};
+
+/*
+ * Tells whether any parameter differs from the shadow copy.
+ */
+class ParamCompareVisitor : public ConfigParamVisitor {
+  public:
+    ParamCompareVisitor(const uint8_t *shadow) {
+      this->shadow = shadow;
+    }
+    boolean changed = false;
+    void bytes(uint8_t *data, uint16_t len) {
+      if (! changed) changed = memcmp(data, shadow + pos, len) != 0;
+      pos += len;
+    }
+  protected:
+    const uint8_t *shadow;
+    uint16_t pos = 0;
+};
+
+/*
+ * Computes the CRC-16 of the parameters.
+ */
+class ParamCRCVisitor : public ConfigParamVisitor {
+  public:
+    ParamCRCVisitor(uint16_t crc) {
+      this->crc = crc;
+    }
+    uint16_t crc;
+    void bytes(uint8_t *data, uint16_t len) {
+      crc = crc16(data, len, crc);
+    }
+};
 
 
-AbstractConfigParams::AbstractConfigParams(AbstractStore *store, const uint8_t version) {
+AbstractConfigParams::AbstractConfigParams(AbstractStore *store, const uint8_t version, bool atomic) {
   this->store = store;
+  this->atomic = atomic;
   this->layoutVersion = version;
 }
 
+uint16_t AbstractConfigParams::paramSize() {
+  ParamSizeVisitor visitor;
+  visitParams(visitor);
+  return visitor.size;
+}
+
+void AbstractConfigParams::visitParams(ConfigParamVisitor &visitor) {
+  // legacy format: the RAM block after the layoutVersion
+  visitor.bytes(((uint8_t *) this) + RAM_PARAM_OFFSET, memSize() - RAM_PARAM_OFFSET);
+}
+
+void AbstractConfigParams::setShadow(uint8_t *buffer) {
+  shadow = buffer;
+  store->readBlock(paramOffset(), shadow, paramSize());
+}
+
+uint16_t AbstractConfigParams::paramOffset() {
+  return atomic ? slotOffset(activeSlot) + SLOT_HEADER_SIZE : STORE_PARAM_OFFSET;
+}
+
+uint16_t AbstractConfigParams::slotOffset(uint8_t slot) {
+  return slot * (store->size() / 2);
+}
+
 uint8_t AbstractConfigParams::magicNumber() {
   return store->read8(0);
 }
 
 uint8_t AbstractConfigParams::version() {
+  if (atomic) return store->read8(slotOffset(activeSlot) + offsetof(ConfigSlotHeader, version));
   return store->read8(MAGIC_NUMBER_SIZE);
 }
 
@@ -52,6 +247,8 @@ void AbstractConfigParams::clear() {
     Serial.println(F("DEBUG_CONFIG Clear"));
   #endif
   store->clear();
+  activeSlot = 1;  // => the next save() writes slot 0
+  sequence = 0;
   // copy 0x0 values from store to memory:
   readParams();
 }
@@ -62,6 +259,35 @@ void AbstractConfigParams::load() {
    Serial.println(F("DEBUG_CONFIG Load"));
   #endif
   
+  if (atomic) {
+    ASSERT(SLOT_HEADER_SIZE + paramSize() <= store->size() / 2, "config slot size");
+    ConfigSlotHeader a, b;
+    const bool validA = readSlotHeader(0, a);
+    const bool validB = readSlotHeader(1, b);
+    boolean updated = true;
+    if (! validA && ! validB) {
+      #ifdef DEBUG_CONFIG
+        Serial.println(F("DEBUG_CONFIG Initialising store (first use or both slots corrupt)"));
+      #endif
+      clear();
+    } else {
+      // the newer of two valid slots (sequence numbers wrap around):
+      activeSlot = validA && (! validB || (int16_t) (a.sequence - b.sequence) > 0) ? 0 : 1;
+      const ConfigSlotHeader &header = activeSlot == 0 ? a : b;
+      sequence = header.sequence;
+      // parameters added since the slot was written are set to 0x0 and get their default values:
+      ParamReadVisitor visitor = ParamReadVisitor(store, paramOffset(), header.length, shadow);
+      visitParams(visitor);
+      updated = header.version != layoutVersion;
+    }
+    boolean defaults;
+    initParams(defaults);
+    if (updated || defaults) {
+      writeSlot();
+    }
+    return;
+  }
+  
   if (magicNumber() != MAGIC_NUMBER) {
     #ifdef DEBUG_CONFIG
       Serial.println(F("DEBUG_CONFIG Initialising store (first use)"));
@@ -96,12 +322,67 @@ void AbstractConfigParams::save() {
     Serial.println(F("DEBUG_CONFIG Save"));
   #endif
   // Don't write magic number and version / layoutVersion:
-  const uint8_t *ptr = (const uint8_t *) (this);
-  ptr += RAM_PARAM_OFFSET;
-  const uint32_t len = memSize() - RAM_PARAM_OFFSET;
-  for (uint32_t i=0; i<len; i++) {
-    store->update8(STORE_PARAM_OFFSET + i, *ptr++);
+  if (atomic) {
+    ParamCompareVisitor visitor = ParamCompareVisitor(shadow);
+    if (shadow != NULL) visitParams(visitor);
+    if (shadow == NULL || visitor.changed) {
+      writeSlot();
+    }
+    return;
+  }
+  if (shadow == NULL) {
+    ParamWriteVisitor visitor = ParamWriteVisitor(store, STORE_PARAM_OFFSET, true, NULL);
+    visitParams(visitor);
+    return;
+  }
+  // write the changed ranges only; merging nearby ranges saves transactions but would rewrite unchanged cells on expiring media:
+  ParamDiffVisitor visitor = ParamDiffVisitor(store, STORE_PARAM_OFFSET, shadow, store->expiringMedia() ? 0 : SAVE_MERGE_GAP);
+  visitParams(visitor);
+  visitor.flush();
+}
+
+bool AbstractConfigParams::readSlotHeader(uint8_t slot, ConfigSlotHeader &header) {
+  store->read(slotOffset(slot), header);
+  if (header.magic != ATOMIC_MAGIC_NUMBER || header.length > store->size() / 2 - SLOT_HEADER_SIZE) return false;
+  uint16_t crc = crc16(&header.version, SLOT_CRC_FIELDS_SIZE);
+  // the parameter values as stored (the length may differ from paramSize()):
+  uint8_t chunk[SLOT_CRC_CHUNK];
+  for (uint16_t i = 0; i < header.length; i += SLOT_CRC_CHUNK) {
+    const uint16_t len = header.length - i < SLOT_CRC_CHUNK ? header.length - i : SLOT_CRC_CHUNK;
+    store->readBlock(slotOffset(slot) + SLOT_HEADER_SIZE + i, chunk, len);
+    crc = crc16(chunk, len, crc);
+  }
+  #ifdef DEBUG_CONFIG
+    Serial.print(F("DEBUG_CONFIG Slot "));
+    Serial.print(slot);
+    Serial.print(F(" sequence "));
+    Serial.print(header.sequence);
+    Serial.println(crc == header.crc ? F(" valid") : F(" CRC mismatch"));
+  #endif
+  return crc == header.crc;
+}
+
+void AbstractConfigParams::writeSlot() {
+  const uint8_t slot = 1 - activeSlot;
+  ConfigSlotHeader header;
+  header.magic = ATOMIC_MAGIC_NUMBER;
+  header.version = layoutVersion;
+  header.sequence = sequence + 1;
+  header.length = paramSize();
+  ParamCRCVisitor crcVisitor = ParamCRCVisitor(crc16(&header.version, SLOT_CRC_FIELDS_SIZE));
+  visitParams(crcVisitor);
+  header.crc = crcVisitor.crc;
+  // values first, header (with the CRC) last; on expiring media only the cells differing from the slot's previous contents are written:
+  const bool update = store->expiringMedia();
+  ParamWriteVisitor writeVisitor = ParamWriteVisitor(store, slotOffset(slot) + SLOT_HEADER_SIZE, update, shadow);
+  visitParams(writeVisitor);
+  if (update) {
+    store->update(slotOffset(slot), header);
+  } else {
+    store->write(slotOffset(slot), header);
   }
+  activeSlot = slot;
+  sequence = header.sequence;
 }
 
 void AbstractConfigParams::readParams() {
@@ -109,12 +390,8 @@ void AbstractConfigParams::readParams() {
     Serial.println(F("DEBUG_CONFIG Read"));
   #endif
   // Don't read magic number and version / layoutVersion:
-  uint8_t *ptr = (uint8_t *) (this);
-  ptr += RAM_PARAM_OFFSET;
-  const uint32_t len = memSize() - RAM_PARAM_OFFSET;
-  for (uint32_t i=0; i<len; i++) {
-	*ptr++ = store->read8(STORE_PARAM_OFFSET + i);
-  }
+  ParamReadVisitor visitor = ParamReadVisitor(store, paramOffset(), paramSize(), shadow);
+  visitParams(visitor);
 }
 
 void AbstractConfigParams::print() {
@@ -21,21 +21,70 @@
    * with additional parameter values. The storage area that is not being used initially will also be initialised 
    * with 0x0; and if more parameters are added later they will be initialised with default values.
    *
+   * Atomic layout (constructor parameter atomic == true): the store is split into two halves (slots A and B) of the structure
+   *
+   * - ConfigSlotHeader: magic number, version, sequence number, length of the parameter values, CRC-16
+   * - Parameter values (length bytes)
+   *
+   * save() writes the slot not holding the current values, header (with the CRC) last, and load() uses the valid slot with the
+   * higher sequence number. If the board loses power during save(), the CRC of the slot being written doesn't match and
+   * load() uses the values saved before.
+   *
+   * The parameter values are stored packed (without padding), in the order in which visitParams() passes them to the visitor.
+   * This format is independent of the compiler's RAM layout, so a store written on the board can be read by a host build.
+   * Subclasses that don't implement visitParams() use the legacy format: the RAM block of the parameters (including padding)
+   * which depends on the RAM layout below. On AVR boards both formats are identical (no padding) if the parameters are
+   * visited in declaration order.
+   *
    * The RAM layout of subclasses of AbstractConfigParams is as follows:
    *
    * - Superclass pointer (2 bytes)
    * - Pointer to AbstractStore (2 bytes)
+   * - Pointer to shadow copy (2 bytes)
+   * - Atomic flag, active slot (1 byte each), sequence number (2 bytes)
    * - Layout version (1 byte)
    * - (actual configuration parameter values (n bytes))
    */
+  /*
+   * Header of a slot of the atomic layout.
+   */
+  struct ConfigSlotHeader {
+    uint8_t magic;
+    uint8_t version;
+    uint16_t sequence;  // incremented by every save()
+    uint16_t length;    // number of bytes of the parameter values
+    uint16_t crc;       // CRC-16 of version, sequence, length and the parameter values
+  };
+
+  /*
+   * Receives the configuration parameters, see AbstractConfigParams::visitParams().
+   */
+  class ConfigParamVisitor {
+    public:
+      /*
+       * Visits a parameter of a fixed-size type (integer, float, enum, array or struct of these).
+       */
+      template<typename T> void param(T &value) {
+        bytes((uint8_t *) &value, sizeof(T));
+      }
+      
+      /*
+       * Visits the given number of bytes of parameter values.
+       */
+      virtual void bytes(uint8_t *data, uint16_t len) = 0;
+  };
+
   class AbstractConfigParams {
 
     public:
       /*
        * @param eepromOffset number of bytes this object's storage is offset from the first byte of the EEPROM store.
        * @param layoutVersion static version identifier of the config data structure. Should be increased whenever the number or parameter,  their types or sizes change.
+       * @param atomic true = use the atomic layout with two slots (see above); each slot takes half of the store, which must hold
+       *        the slot header plus paramSize() (checked by load()).
+       *        Switching between the layouts resets the parameter values to their defaults.
        */
-      AbstractConfigParams(AbstractStore *store, const uint8_t version);
+      AbstractConfigParams(AbstractStore *store, const uint8_t version, bool atomic = false);
       
       /*
        * Returns the version identifier.
@@ -54,9 +103,26 @@
       
       /*
        * Saves (changed) parameter values to the EEPROM.
+       * With a shadow copy (see setShadow()) only the changed byte ranges are written, without reading the store,
+       * else all parameter values are passed to the store's updateBlock().
+       * Atomic layout: all parameter values are written to the other slot (nothing if the shadow copy shows no changes). On expiring
+       * media (EEPROM) they are passed to updateBlock(), which reads the whole slot but only writes the cells that differ from the
+       * values saved before the last save(), so the wear stays that of the changed parameters (and the slot header).
        */
       void save();
 
+      /*
+       * Provides RAM for a copy of the parameter values as last read from or written to the store, which lets save() find
+       * the changed values without reading the store. The values are read from the store into the buffer immediately.
+       * @param buffer must remain allocated as long as this object is used; its size must be at least paramSize()
+       */
+      void setShadow(uint8_t *buffer);
+
+      /*
+       * Returns the number of bytes of the stored parameter values.
+       */
+      uint16_t paramSize();
+
       /*
        * Print config parameter values to Serial.<p>
 	   *
@@ -74,6 +140,20 @@
 	   * Used storage area.
 	   */
 	  AbstractStore *store;
+	  
+	  /*
+	   * Optional shadow copy of the parameter values on the store, see setShadow().
+	   * Note: must be declared before layoutVersion, see RAM layout.
+	   */
+	  uint8_t *shadow = NULL;
+	  
+	  /*
+	   * Atomic layout: the slot holding the current values (0 or 1) and its sequence number.
+	   * Note: must be declared before layoutVersion, see RAM layout.
+	   */
+	  bool atomic;
+	  uint8_t activeSlot = 0;
+	  uint16_t sequence = 0;
 
       /*
        * Version identifier of the config data structure.
@@ -91,10 +171,39 @@
 	   */
 	  virtual void initParams(boolean &updated) = 0;
 	  
+	  /*
+	   * Passes every parameter to visitor.param(); this defines the storage format (see above). A subclass implementing it
+	   * must not invoke AbstractConfigParams::visitParams() (the legacy format), but subclasses of such subclasses invoke
+	   * "super" first, then visit their own parameters.
+	   *
+	   * Example: void visitParams(ConfigParamVisitor &visitor) { visitor.param(interval); visitor.param(sensorIDs); }
+	   */
+	  virtual void visitParams(ConfigParamVisitor &visitor);
+	  
       /*
        * Reads the configuration values (and only these) from the EEPROM. No initialisation of values is performed.
        */
       void readParams();
+      
+      /*
+       * Returns the offset of the parameter values on the store (of the active slot if atomic).
+       */
+      uint16_t paramOffset();
+      
+      /*
+       * Atomic layout: returns the offset of the given slot on the store.
+       */
+      uint16_t slotOffset(uint8_t slot);
+      
+      /*
+       * Atomic layout: reads the header of the given slot; returns false if the slot doesn't hold valid parameter values.
+       */
+      bool readSlotHeader(uint8_t slot, ConfigSlotHeader &header);
+      
+      /*
+       * Atomic layout: writes the parameter values to the slot not holding the current values, then makes it the active slot.
+       */
+      void writeSlot();
   };
 
 
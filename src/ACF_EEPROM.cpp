@@ -53,4 +53,62 @@ bool EEPROMStore::update8(uint32_t idx, uint8_t val) {
   return true;
 }
 
+void EEPROMStore::readBlock(uint32_t idx, uint8_t *buf, uint32_t len) {
+  #if defined(__AVR__)
+    eeprom_read_block((void *) buf, (const void *) (offsetBytes + idx), len);
+  #else
+    const uint32_t maxIndex = offsetBytes + idx + len;
+    for (uint32_t i = offsetBytes + idx; i < maxIndex; i++) {
+      *buf++ = EEPROM.read(i);
+    }
+  #endif
+  #if defined DEBUG_EEPROM
+    Serial.print(F("DEBUG_EEPROM readB ["));
+    Serial.print(offsetBytes + idx);
+    Serial.print(F(".."));
+    Serial.print(offsetBytes + idx + len - 1);
+    Serial.println(']');
+  #endif
+}
+
+void EEPROMStore::writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  #if defined(__AVR__)
+    eeprom_write_block((const void *) buf, (void *) (offsetBytes + idx), len);
+  #else
+    const uint32_t maxIndex = offsetBytes + idx + len;
+    for (uint32_t i = offsetBytes + idx; i < maxIndex; i++) {
+      EEPROM.write(i, *buf++);
+    }
+  #endif
+  #ifdef DEBUG_EEPROM
+    Serial.print(F("DEBUG_EEPROM writeB["));
+    Serial.print(offsetBytes + idx);
+    Serial.print(F(".."));
+    Serial.print(offsetBytes + idx + len - 1);
+    Serial.println(']');
+  #endif
+}
+
+bool EEPROMStore::updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  // eeprom_update_block() would not tell whether any cell was changed:
+  bool updated = false;
+  const uint32_t maxIndex = offsetBytes + idx + len;
+  for (uint32_t i = offsetBytes + idx; i < maxIndex; i++, buf++) {
+    if (EEPROM.read(i) != *buf) {
+      EEPROM.write(i, *buf);
+      updated = true;
+    }
+  }
+  #ifdef DEBUG_EEPROM
+    if (updated) {
+      Serial.print(F("DEBUG_EEPROM updB  ["));
+      Serial.print(offsetBytes + idx);
+      Serial.print(F(".."));
+      Serial.print(maxIndex - 1);
+      Serial.println(']');
+    }
+  #endif
+  return updated;
+}
+
 #endif
@@ -67,6 +67,21 @@
 	   * @result return true if val is different from current value, i.e. cell was changed, false otherwise
        */
       bool update8(uint32_t idx, uint8_t val);
+      
+      /*
+       * Read a contiguous block of bytes from this store without the per-byte overhead of read8().
+       */
+      void readBlock(uint32_t idx, uint8_t *buf, uint32_t len);
+      
+      /*
+       * Write a contiguous block of bytes to this store (unconditionally). Use updateBlock() if possible.
+       */
+      void writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+      
+      /*
+       * Write a contiguous block of bytes to this store; only the cells whose values differ are written. Prefer this function to writeBlock().
+       */
+      bool updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
   };
 
 #endif
@@ -1,14 +1,16 @@
-
+#include <Wire.h>
 #include <ACF_FRAM.h>
 
 // #define DEBUG_FRAM
 
+static const uint8_t ZEROES[FRAM_WRITE_CHUNK_SIZE] = { 0 };
 
 bool FRAMStore::init(uint8_t addr) {
   #ifdef DEBUG_FRAM
     Serial.println(F("DEBUG_FRAM init()"));
   #endif
-  return fram->begin(addr);}
+  device->i2cAddr = addr;
+  return device->fram.begin(addr);}
 
 void FRAMStore::clear() {
   const uint32_t maxIndex = offsetBytes + sizeBytes;
@@ -19,13 +21,15 @@ void FRAMStore::clear() {
 	Serial.print(maxIndex-1);
 	Serial.println(']');
   #endif
-  for (uint32_t i = offsetBytes;  i < maxIndex ; i++) {
-    fram->write8(i, 0x0);
+  for (uint32_t i = offsetBytes;  i < maxIndex ; i += FRAM_WRITE_CHUNK_SIZE) {
+    const uint32_t remaining = maxIndex - i;
+    writeChunk(i, ZEROES, remaining < FRAM_WRITE_CHUNK_SIZE ? remaining : FRAM_WRITE_CHUNK_SIZE);
   }
 }
 
 uint8_t FRAMStore::read8(uint32_t idx) {
-  const uint8_t val = fram->read8(offsetBytes + idx);
+  uint8_t val;
+  readChunk(offsetBytes + idx, &val, 1);
   #if defined DEBUG_FRAM
     Serial.print(F("DEBUG_FRAM read ["));
     Serial.print(offsetBytes + idx);
@@ -36,7 +40,7 @@ uint8_t FRAMStore::read8(uint32_t idx) {
 }
 
 void FRAMStore::write8(uint32_t idx, uint8_t val) {
-  fram->write8(offsetBytes + idx, val);
+  writeChunk(offsetBytes + idx, &val, 1);
   #ifdef DEBUG_FRAM
     Serial.print(F("DEBUG_FRAM write["));
     Serial.print(offsetBytes + idx);
@@ -46,9 +50,10 @@ void FRAMStore::write8(uint32_t idx, uint8_t val) {
 }
 
 bool FRAMStore::update8(uint32_t idx, uint8_t val) {
-  const uint8_t current = fram->read8(offsetBytes + idx);
+  uint8_t current;
+  readChunk(offsetBytes + idx, &current, 1);
   if (current == val) return false;
-  fram->write8(offsetBytes + idx, val);
+  writeChunk(offsetBytes + idx, &val, 1);
   #ifdef DEBUG_FRAM
     Serial.print(F("DEBUG_FRAM upd  ["));
     Serial.print(offsetBytes + idx);
@@ -58,3 +63,81 @@ bool FRAMStore::update8(uint32_t idx, uint8_t val) {
   return true;
 }
 
+void FRAMStore::readBlock(uint32_t idx, uint8_t *buf, uint32_t len) {
+  const uint32_t maxIndex = offsetBytes + idx + len;
+  for (uint32_t i = offsetBytes + idx; i < maxIndex; i += FRAM_READ_CHUNK_SIZE) {
+    const uint32_t remaining = maxIndex - i;
+    const uint8_t n = remaining < FRAM_READ_CHUNK_SIZE ? remaining : FRAM_READ_CHUNK_SIZE;
+    readChunk(i, buf, n);
+    buf += n;
+  }
+  #if defined DEBUG_FRAM
+    Serial.print(F("DEBUG_FRAM readB["));
+    Serial.print(offsetBytes + idx);
+    Serial.print(F(".."));
+    Serial.print(maxIndex - 1);
+    Serial.println(']');
+  #endif
+}
+
+void FRAMStore::writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  const uint32_t maxIndex = offsetBytes + idx + len;
+  for (uint32_t i = offsetBytes + idx; i < maxIndex; i += FRAM_WRITE_CHUNK_SIZE) {
+    const uint32_t remaining = maxIndex - i;
+    const uint8_t n = remaining < FRAM_WRITE_CHUNK_SIZE ? remaining : FRAM_WRITE_CHUNK_SIZE;
+    writeChunk(i, buf, n);
+    buf += n;
+  }
+  #ifdef DEBUG_FRAM
+    Serial.print(F("DEBUG_FRAM writB["));
+    Serial.print(offsetBytes + idx);
+    Serial.print(F(".."));
+    Serial.print(maxIndex - 1);
+    Serial.println(']');
+  #endif
+}
+
+bool FRAMStore::updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  bool updated = false;
+  uint8_t current[FRAM_WRITE_CHUNK_SIZE];
+  const uint32_t maxIndex = offsetBytes + idx + len;
+  for (uint32_t i = offsetBytes + idx; i < maxIndex; i += FRAM_WRITE_CHUNK_SIZE) {
+    const uint32_t remaining = maxIndex - i;
+    const uint8_t n = remaining < FRAM_WRITE_CHUNK_SIZE ? remaining : FRAM_WRITE_CHUNK_SIZE;
+    readChunk(i, current, n);
+    if (memcmp(current, buf, n) != 0) {
+      writeChunk(i, buf, n);
+      updated = true;
+    }
+    buf += n;
+  }
+  #ifdef DEBUG_FRAM
+    if (updated) {
+      Serial.print(F("DEBUG_FRAM updB ["));
+      Serial.print(offsetBytes + idx);
+      Serial.print(F(".."));
+      Serial.print(maxIndex - 1);
+      Serial.println(']');
+    }
+  #endif
+  return updated;
+}
+
+void FRAMStore::readChunk(uint16_t framAddr, uint8_t *buf, uint8_t len) {
+  Wire.beginTransmission(device->i2cAddr);
+  Wire.write(framAddr >> 8);
+  Wire.write(framAddr & 0xFF);
+  Wire.endTransmission();
+  Wire.requestFrom(device->i2cAddr, len);
+  for (uint8_t i = 0; i < len; i++) {
+    *buf++ = Wire.read();
+  }
+}
+
+void FRAMStore::writeChunk(uint16_t framAddr, const uint8_t *buf, uint8_t len) {
+  Wire.beginTransmission(device->i2cAddr);
+  Wire.write(framAddr >> 8);
+  Wire.write(framAddr & 0xFF);
+  Wire.write(buf, len);
+  Wire.endTransmission();
+}
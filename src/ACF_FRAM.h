@@ -3,32 +3,57 @@
 
   #include "Adafruit_FRAM_I2C.h"
   #include <ACF_Store.h>
-  
+
+  // Define this symbol (e.g. as a build flag) to match the buffer size of the Wire library of your board (in Byte):
+  //
+  // Note: the AVR Wire library defines BUFFER_LENGTH; 2 bytes of every write transmission are taken by the memory address.
+  #ifndef FRAM_I2C_BUFFER_SIZE
+    #ifdef BUFFER_LENGTH
+      #define FRAM_I2C_BUFFER_SIZE BUFFER_LENGTH
+    #else
+      #define FRAM_I2C_BUFFER_SIZE 32
+    #endif
+  #endif
+
+  #define FRAM_READ_CHUNK_SIZE  FRAM_I2C_BUFFER_SIZE
+  #define FRAM_WRITE_CHUNK_SIZE (FRAM_I2C_BUFFER_SIZE - 2)
+
+  /*
+   * The FRAM chip shared by all the FRAMStores allocated on it.
+   */
+  struct FRAMDevice {
+    Adafruit_FRAM_I2C fram;
+    uint8_t i2cAddr = MB85RC_DEFAULT_ADDRESS;
+  };
+
   /*
    * A contiguous part of an Arduino's external Adafruit FRAM I2C storage space.<p>
    *
+   * Multi-byte access uses the sequential read and write modes of the MB85RC chips: a block is split into chunks that fit the
+   * Wire buffer and each chunk is streamed in one addressed I2C transaction (rather than one transaction per byte).
+   *
    * Note: This store must be initialised using init() after creation.
    */
   class FRAMStore : public AbstractStore {
   public:
-	  
+
 	  /*
 	   * @param offset number of bytesthe first byte of this store is offset from the first byte of the underlying FRAM storage.
 	   * @param number of bytes allocated to this store from the underlying FRAM storage space
 	   */
-	  FRAMStore(const uint32_t offset, const uint32_t size) : AbstractStore(offset, size)  { fram = new Adafruit_FRAM_I2C();}
-	  
+	  FRAMStore(const uint32_t offset, const uint32_t size) : AbstractStore(offset, size)  { device = new FRAMDevice();}
+
 	  /*
 	   * Convenience constructor; allocates storage at offset 0x0.
 	   */
 	  FRAMStore(const uint32_t size) : FRAMStore((uint32_t) 0, size)  { }
-	  
+
 	  /*
 	   * Convenience constructor; allocates storage on the same FRAM chip and immediately adjacent to another FRAMStore
 	   * beginning at the next higher cell address.
 	   */
-	  FRAMStore(FRAMStore *predecessor, const uint32_t size) : AbstractStore(predecessor->offset() + predecessor->size(), size)  { fram = predecessor->fram; }
-	  
+	  FRAMStore(FRAMStore *predecessor, const uint32_t size) : AbstractStore(predecessor->offset() + predecessor->size(), size)  { device = predecessor->device; }
+
 	  /*
 	   * Initialise connection to FRAM board.<p>
 	   *
@@ -38,12 +63,12 @@
 	   * @result return true if connection to FRAM board was successful, else return false.
 	   */
 	  bool init(uint8_t addr = MB85RC_DEFAULT_ADDRESS);
-	  
+
 	  /*
 	   * FRAM supports trillions of writes.
 	   */
 	  bool expiringMedia() { return false; };
-      
+
       /*
        * Set all the bytes allocated to this store to 0x0 on the underlying FRAM storage and reset in-memory storage-managment structures of this store.
        */
@@ -55,7 +80,7 @@
        * @return byte value read from the underlying storage media
        */
       uint8_t read8(uint32_t idx);
-    
+
       /*
        * Write one byte to this store.
        *
@@ -63,17 +88,44 @@
        * @param val byte value writen to the underlying storage media
        */
       void write8(uint32_t idx, uint8_t val);
-    
+
       /*
        * Semantics equivalent to write().
        */
       bool update8(uint32_t idx, uint8_t val);
 
+      /*
+       * Read a contiguous block of bytes from this store using sequential-read transactions of at most FRAM_READ_CHUNK_SIZE bytes.
+       */
+      void readBlock(uint32_t idx, uint8_t *buf, uint32_t len);
+
+      /*
+       * Write a contiguous block of bytes to this store using sequential-write transactions of at most FRAM_WRITE_CHUNK_SIZE bytes.
+       */
+      void writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+
+      /*
+       * Write a contiguous block of bytes to this store; only the chunks containing changed bytes are written.
+       */
+      bool updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+
     protected:
 	  /*
 	   * Underlying physical memory.
 	   */
-	  Adafruit_FRAM_I2C *fram;
+	  FRAMDevice *device;
+
+	  /*
+	   * Reads len bytes starting at the absolute FRAM address in one addressed I2C transaction.
+	   * Note: len must not exceed FRAM_READ_CHUNK_SIZE.
+	   */
+	  void readChunk(uint16_t framAddr, uint8_t *buf, uint8_t len);
+
+	  /*
+	   * Writes len bytes starting at the absolute FRAM address in one addressed I2C transaction.
+	   * Note: len must not exceed FRAM_WRITE_CHUNK_SIZE.
+	   */
+	  void writeChunk(uint16_t framAddr, const uint8_t *buf, uint8_t len);
   };
 
 #endif
@@ -0,0 +1,479 @@
+#include <ACF_FrameLog.h>
+#include <ACF_Messages.h>
+
+// #define DEBUG_FRAME_LOG
+
+/*
+ * The magic number is the first byte of the log area, see ACF_Logging.cpp. It differs from the one of AbstractLog, so switching
+ * a store between the two log formats clears the log.
+ */
+const uint8_t FRAME_LOG_MAGIC_NUMBER = 197;
+
+/*
+ * Takes the place of the size byte of a frame that did not fit before the end of the ring; the next frame starts at offset 0.
+ */
+const uint8_t WRAP_MARKER = 0xFF;
+
+/*
+ * The compact format (see ACF_FrameLog.h) has its own magic number.
+ */
+const uint8_t COMPACT_FRAME_LOG_MAGIC_NUMBER = 196;
+
+#define MAGIC_NUMBER_SIZE sizeof(uint8_t)
+#define RING_SIZE_SIZE sizeof(uint16_t)
+#define RING_OFFSET (MAGIC_NUMBER_SIZE + RING_SIZE_SIZE)
+#define FRAME_MIN_SIZE (sizeof(uint8_t) + 1 + sizeof(T_LogDataType_ID) + sizeof(uint8_t))
+#define FRAME_MAX_HEADER_SIZE (LOG_FRAME_MAX_OVERHEAD - sizeof(uint8_t))
+#define MAX_VARINT_SIZE 5
+#define KEYFRAME_FLAG 0x0
+#define MAX_RING_SIZE 0xFF00
+#define CHUNK_SIZE 16
+
+static const uint8_t ZEROES[CHUNK_SIZE] = { 0 };
+
+/*
+ * Writes v as unsigned LEB128 varint (7 bits per byte, least significant first, high bit set on all but the last byte).
+ * @return number of bytes written
+ */
+static uint8_t encodeVarint(uint32_t v, uint8_t *buf) {
+  uint8_t n = 0;
+  while (v >= 0x80) {
+    buf[n++] = (v & 0x7F) | 0x80;
+    v >>= 7;
+  }
+  buf[n++] = v;
+  return n;
+}
+
+/*
+ * @return number of bytes read
+ */
+static uint8_t decodeVarint(const uint8_t *buf, uint32_t &v) {
+  uint8_t n = 0;
+  v = 0;
+  do {
+    v |= (uint32_t) (buf[n] & 0x7F) << (7 * n);
+  } while ((buf[n++] & 0x80) && n < MAX_VARINT_SIZE);
+  return n;
+}
+
+
+AbstractFrameLog::AbstractFrameLog(AbstractStore *store, uint8_t keyframeInterval) {
+  ASSERT(store != NULL, "constructor:store");
+  this->store = store;
+  this->keyframeInterval = keyframeInterval;
+  const uint32_t bytes = store->size() - RING_OFFSET;
+  ringBytes = bytes < MAX_RING_SIZE ? bytes : MAX_RING_SIZE;
+  wrapIndex = ringBytes;
+}
+
+uint8_t AbstractFrameLog::magicNumber() {
+  return store->read8(0);
+}
+
+uint16_t AbstractFrameLog::ringOffset(uint16_t index) {
+  return RING_OFFSET + index;
+}
+
+uint16_t AbstractFrameLog::ringSize() {
+  return ringBytes;
+}
+
+uint16_t AbstractFrameLog::currentLogEntries() {
+  return entries;
+}
+
+uint16_t AbstractFrameLog::currentLogBytes() {
+  if (entries == 0) return 0;
+  if (logHeadIndex > logTailIndex) return logHeadIndex - logTailIndex;
+  return (wrapIndex - logTailIndex) + logHeadIndex;
+}
+
+void AbstractFrameLog::clear() {
+  #ifdef DEBUG_FRAME_LOG
+    Serial.print(F("DEBUG_FRAME_LOG: clear() [new] ring size: "));
+    Serial.println(ringBytes);
+  #endif
+  store->update8(0, keyframeInterval == 0 ? FRAME_LOG_MAGIC_NUMBER : COMPACT_FRAME_LOG_MAGIC_NUMBER);
+  store->update(MAGIC_NUMBER_SIZE, ringBytes);
+  clearBytes(0, ringBytes);
+  logTime.reset();
+  reader.valid = false;
+  logHeadIndex = 0;
+  logTailIndex = 0;
+  wrapIndex = ringBytes;
+  entries = 0;
+  unnotifiedIndex = 0;
+  unnotifiedEntries = 0;
+  lastTimestamp = 0L;
+  keyframes = 0;
+  framesSinceKeyframe = 0;
+  // write a log message so there is always at least one log entry:
+  logMessage(static_cast<T_Message_ID>(ACF_Msg::LOG_INIT), 0, 0);
+}
+
+
+void AbstractFrameLog::init() {
+  //
+  // Check if the size of the ring has changed (typically by changing from unit tests to production):
+  //
+  uint16_t oldRingBytes;
+  store->read(MAGIC_NUMBER_SIZE, oldRingBytes);
+  #ifdef DEBUG_FRAME_LOG
+    Serial.print(F("DEBUG_FRAME_LOG: init() stored ring size: "));
+    Serial.println(oldRingBytes);
+  #endif
+  const bool wrongMagicNumber = magicNumber() != (keyframeInterval == 0 ? FRAME_LOG_MAGIC_NUMBER : COMPACT_FRAME_LOG_MAGIC_NUMBER);
+  const bool ringSizeChanged = oldRingBytes != ringBytes;
+  if (wrongMagicNumber || ringSizeChanged) {
+    clear();
+    if (wrongMagicNumber) {
+      logMessage(static_cast<T_Message_ID>(ACF_Msg::LOG_MAGIC_NUMBER), 0, 0);
+	} else {
+	  logMessage(static_cast<T_Message_ID>(ACF_Msg::LOG_SIZE_CHG), oldRingBytes, ringBytes);
+	}
+    return;
+  }
+  reader.valid = false;
+  entries = 0;
+  keyframes = 0;
+
+  // find log head: follow the frames from offset 0 to the first 0x0 byte
+  uint16_t index = 0;
+  uint8_t frame[2];  // size + first byte of timestamp (= keyframe flag in the compact format)
+  uint16_t newestFrames = 0;       // frames from offset 0 to the head
+  uint16_t sinceNewestKey = 0;     // of these, frames after the most recent keyframe
+  bool newestKey = false;
+  for (;;) {
+    frame[1] = 0;
+    store->readBlock(ringOffset(index), frame, index + 1 < ringBytes ? 2 : 1);
+    if (frame[0] == 0) break;
+    ASSERT(frame[0] != WRAP_MARKER && frame[0] >= FRAME_MIN_SIZE && (uint32_t) index + frame[0] < ringBytes, "initLog:head");
+    newestFrames++;
+    if (keyframeInterval != 0 && frame[1] == KEYFRAME_FLAG) {
+      keyframes++;
+      newestKey = true;
+      sinceNewestKey = 0;
+    } else {
+      sinceNewestKey++;
+    }
+    index += frame[0];
+  }
+  logHeadIndex = index;
+
+  // find log tail: the first non-zero byte behind the head starts the oldest frame, else the oldest frame is at offset 0
+  uint8_t buf[CHUNK_SIZE];
+  bool found = false;
+  while (index < ringBytes && ! found) {
+    const uint16_t remaining = ringBytes - index;
+    const uint8_t n = remaining < CHUNK_SIZE ? remaining : CHUNK_SIZE;
+    store->readBlock(ringOffset(index), buf, n);
+    uint8_t i = 0;
+    while (i < n && buf[i] == 0) i++;
+    found = i < n;
+    index += i;
+  }
+  uint16_t sinceOldestKey = 0;
+  if (found && store->read8(ringOffset(index)) != WRAP_MARKER) {
+    logTailIndex = index;
+    // count the frames up to the end of their round through the ring:
+    while (index < ringBytes) {
+      frame[1] = 0;
+      store->readBlock(ringOffset(index), frame, index + 1 < ringBytes ? 2 : 1);
+      if (frame[0] == WRAP_MARKER) break;
+      ASSERT(frame[0] >= FRAME_MIN_SIZE && (uint32_t) index + frame[0] <= ringBytes, "initLog:tail");
+      entries++;
+      if (keyframeInterval != 0 && frame[1] == KEYFRAME_FLAG) {
+        keyframes++;
+        sinceOldestKey = 0;
+      } else {
+        sinceOldestKey++;
+      }
+      index += frame[0];
+    }
+    wrapIndex = index;
+  } else {
+    logTailIndex = 0;
+    wrapIndex = ringBytes;
+  }
+  entries += newestFrames;
+  ASSERT(entries > 0, "initLog:entries");
+  ASSERT(keyframeInterval == 0 || keyframes > 0, "initLog:keyframe");
+  const uint16_t sinceKey = newestKey ? sinceNewestKey : sinceOldestKey + newestFrames;
+  framesSinceKeyframe = sinceKey < keyframeInterval ? sinceKey : keyframeInterval;
+
+  // seek the nearest keyframe to rebuild the most recent timestamp:
+  lastTimestamp = frameTimestamp(previousFrameIndex(logHeadIndex));
+  ASSERT(lastTimestamp != 0L, "initLog:timestamp");
+  logTime.adjust(lastTimestamp);
+
+  unnotifiedIndex = logHeadIndex;
+  unnotifiedEntries = 0;
+  #ifdef DEBUG_FRAME_LOG
+	Serial.print(F("           init() entries: "));
+	Serial.println(entries);
+  #endif
+}
+
+uint16_t AbstractFrameLog::nextFrameIndex(uint16_t index, uint8_t size) {
+  const uint16_t next = index + size;
+  return next >= wrapIndex ? 0 : next;
+}
+
+uint16_t AbstractFrameLog::previousFrameIndex(uint16_t index) {
+  if (index == 0) index = wrapIndex;
+  return index - store->read8(ringOffset(index - 1));
+}
+
+void AbstractFrameLog::readFrameHeader(uint16_t index, LogFrameHeader &header) {
+  uint8_t buf[FRAME_MAX_HEADER_SIZE];
+  const uint8_t size = store->read8(ringOffset(index));
+  const uint8_t n = size - sizeof(uint8_t) < FRAME_MAX_HEADER_SIZE ? size - sizeof(uint8_t) : FRAME_MAX_HEADER_SIZE;
+  store->readBlock(ringOffset(index + sizeof(uint8_t)), buf, n);
+  header.size = size;
+  uint8_t i = 0;
+  if (keyframeInterval == 0) {
+    header.keyframe = true;
+    header.delta = 0L;
+  } else {
+    header.keyframe = buf[0] == KEYFRAME_FLAG;
+    if (header.keyframe) i++;
+    i += decodeVarint(buf + i, header.delta);
+  }
+  if (header.keyframe) {
+    memcpy(&header.timestamp, buf + i, sizeof(Timestamp));
+    i += sizeof(Timestamp);
+  }
+  header.type = buf[i++];
+  header.headerSize = sizeof(uint8_t) + i;
+}
+
+void AbstractFrameLog::readFramePayload(uint16_t index, LogFrameHeader &header, LogFrame &frame, uint8_t *payload, uint8_t maxLength) {
+  frame.type = header.type;
+  frame.length = header.size - header.headerSize - sizeof(uint8_t);
+  const uint8_t n = frame.length < maxLength ? frame.length : maxLength;
+  if (n > 0) {
+    store->readBlock(ringOffset(index + header.headerSize), payload, n);
+  }
+}
+
+Timestamp AbstractFrameLog::frameTimestamp(uint16_t index) {
+  LogFrameHeader header;
+  Timestamp sum = 0L;
+  // backwards to the nearest keyframe: timestamp = keyframe timestamp + deltas of the frames after it
+  uint16_t i = index;
+  for (;;) {
+    readFrameHeader(i, header);
+    if (header.keyframe) return header.timestamp + sum;
+    sum += header.delta;
+    if (i == logTailIndex) break;
+    i = previousFrameIndex(i);
+  }
+  // the preceding keyframe has been removed => forwards to the next keyframe: timestamp = keyframe timestamp - deltas up to and including it
+  sum = 0L;
+  i = index;
+  do {
+    readFrameHeader(i, header);
+    i = nextFrameIndex(i, header.size);
+    ASSERT(i != logHeadIndex, "frameTimestamp:keyframe");
+    readFrameHeader(i, header);
+    sum += header.delta;
+  } while (! header.keyframe);
+  return header.timestamp - sum;
+}
+
+void AbstractFrameLog::clearBytes(uint16_t index, uint16_t len) {
+  // clear backwards, so a frame that is cleared only partially (reset) keeps its size byte and can still be skipped
+  uint16_t end = index + len;
+  while (end > index) {
+    const uint8_t n = end - index < CHUNK_SIZE ? end - index : CHUNK_SIZE;
+    end -= n;
+    store->updateBlock(ringOffset(end), ZEROES, n);
+  }
+}
+
+void AbstractFrameLog::removeTailFrame() {
+  const uint16_t removed = logTailIndex;
+  uint8_t frame[2];
+  store->readBlock(ringOffset(removed), frame, 2);
+  if (keyframeInterval != 0 && frame[1] == KEYFRAME_FLAG) {
+    keyframes--;
+  }
+  clearBytes(removed, frame[0]);
+  entries--;
+  logTailIndex += frame[0];
+  if (logTailIndex >= wrapIndex) {
+    if (wrapIndex < ringBytes) {
+      store->update8(ringOffset(wrapIndex), 0);
+    }
+    logTailIndex = 0;
+    wrapIndex = ringBytes;
+  }
+  if (unnotifiedEntries > 0 && unnotifiedIndex == removed) {
+    unnotifiedIndex = logTailIndex;
+    unnotifiedEntries--;
+  }
+  if (entries == 0) {
+    logTailIndex = logHeadIndex;
+    unnotifiedIndex = logHeadIndex;
+  }
+}
+
+void AbstractFrameLog::makeRoom(uint8_t size) {
+  if ((uint32_t) logHeadIndex + size > ringBytes) {
+    // the frame doesn't fit before the end of the ring => end this round with a wrap marker (the oldest frames may lie behind the head)
+    while (entries > 0 && logTailIndex > logHeadIndex) {
+      removeTailFrame();
+    }
+    if (entries > 0) {
+      store->update8(ringOffset(logHeadIndex), WRAP_MARKER);
+      wrapIndex = logHeadIndex;
+    } else {
+      logTailIndex = 0;
+      unnotifiedIndex = 0;
+    }
+    logHeadIndex = 0;
+  }
+  // make room for the frame and for the 0x0 byte behind it:
+  const uint16_t needed = size + 1;
+  while (entries > 0 && (uint16_t) ((logTailIndex + ringBytes - logHeadIndex) % ringBytes) < needed) {
+    removeTailFrame();
+  }
+}
+
+
+/*
+ * Generic log-frame creation.
+ */
+Timestamp AbstractFrameLog::addLogFrame(T_LogDataType_ID type, const void *payload, uint8_t len) {
+  ASSERT(len <= LOG_FRAME_MAX_PAYLOAD && len + LOG_FRAME_MAX_OVERHEAD < ringBytes, "addLogFrame:len");
+  reader.valid = false;
+  const Timestamp ts = logTime.timestamp();
+
+  // header without the size byte:
+  uint8_t header[FRAME_MAX_HEADER_SIZE];
+  uint8_t headerSize;
+  bool keyframe = keyframeInterval == 0 || keyframes == 0 || framesSinceKeyframe + 1 >= keyframeInterval;
+  for (;;) {
+    headerSize = 0;
+    if (keyframeInterval != 0) {
+      if (keyframe) header[headerSize++] = KEYFRAME_FLAG;
+      headerSize += encodeVarint(entries == 0 ? 0L : ts - lastTimestamp, header + headerSize);
+    }
+    if (keyframe) {
+      memcpy(header + headerSize, &ts, sizeof(Timestamp));
+      headerSize += sizeof(Timestamp);
+    }
+    header[headerSize++] = type;
+    makeRoom(sizeof(uint8_t) + headerSize + len + sizeof(uint8_t));
+    // removing the oldest frames must not remove the last keyframe:
+    if (keyframe || keyframes > 0) break;
+    keyframe = true;
+  }
+  const uint8_t size = sizeof(uint8_t) + headerSize + len + sizeof(uint8_t);
+
+  const uint16_t index = logHeadIndex;
+  if (len > 0) {
+    store->updateBlock(ringOffset(index + sizeof(uint8_t) + headerSize), (const uint8_t *) payload, len);
+  }
+  store->update8(ringOffset(index + size - 1), size);
+  // the size byte is written last: the frame only exists once it is complete
+  store->updateBlock(ringOffset(index + sizeof(uint8_t)), header, headerSize);
+  store->update8(ringOffset(index), size);
+
+  logHeadIndex = nextFrameIndex(index, size);
+  if (entries == 0) {
+    logTailIndex = index;
+  }
+  entries++;
+  if (unnotifiedEntries == 0) {
+    unnotifiedIndex = index;
+  }
+  unnotifiedEntries++;
+  lastTimestamp = ts;
+  if (keyframeInterval != 0) {
+    if (keyframe) {
+      keyframes++;
+      framesSinceKeyframe = 0;
+    } else {
+      framesSinceKeyframe++;
+    }
+  }
+  #ifdef DEBUG_FRAME_LOG
+	Serial.print(F("DEBUG_FRAME_LOG: addLogFrame() type: "));
+	Serial.print(type);
+	Serial.print(F(" size: "));
+	Serial.print(size);
+	Serial.print(F(" head: "));
+	Serial.print(logHeadIndex);
+	Serial.print(F(" tail: "));
+	Serial.println(logTailIndex);
+  #endif
+  return ts;
+}
+
+void AbstractFrameLog::readMostRecentLogEntries(uint16_t maxResults) {
+  reader.kind = LogReaderKind::MOST_RECENT;
+  if (maxResults == 0) {
+    reader.toRead = entries;
+  } else {
+    reader.toRead = maxResults < entries ? maxResults : entries;
+  }
+  reader.read = 0;
+  reader.nextIndex = logHeadIndex;  // frames are read backwards from here
+  readerTimestamp = lastTimestamp;
+  reader.valid = true;
+}
+
+void AbstractFrameLog::readUnnotifiedLogEntries() {
+  reader.kind = LogReaderKind::UNNOTIFIED;
+  reader.toRead = unnotifiedEntries;
+  reader.read = 0;
+  reader.nextIndex = unnotifiedIndex;
+  if (keyframeInterval != 0 && unnotifiedEntries > 0) {
+    LogFrameHeader header;
+    readFrameHeader(unnotifiedIndex, header);
+    readerTimestamp = frameTimestamp(unnotifiedIndex) - header.delta;
+  }
+  reader.valid = true;
+}
+
+boolean AbstractFrameLog::nextLogFrame(LogFrame &frame, uint8_t *payload, uint8_t maxLength) {
+  if (reader.valid && reader.read < reader.toRead) {
+    LogFrameHeader header;
+    if (reader.kind == LogReaderKind::MOST_RECENT) {
+      reader.nextIndex = previousFrameIndex(reader.nextIndex);
+      readFrameHeader(reader.nextIndex, header);
+      frame.timestamp = header.keyframe ? header.timestamp : readerTimestamp;
+      readerTimestamp = frame.timestamp - header.delta;
+      readFramePayload(reader.nextIndex, header, frame, payload, maxLength);
+
+    } else if (reader.kind == LogReaderKind::UNNOTIFIED) {
+      readFrameHeader(reader.nextIndex, header);
+      frame.timestamp = header.keyframe ? header.timestamp : readerTimestamp + header.delta;
+      readerTimestamp = frame.timestamp;
+      readFramePayload(reader.nextIndex, header, frame, payload, maxLength);
+      reader.nextIndex = nextFrameIndex(reader.nextIndex, header.size);
+      unnotifiedIndex = reader.nextIndex;
+      unnotifiedEntries--;
+    }
+    reader.read++;
+    #ifdef DEBUG_FRAME_LOG
+      Serial.print(F("DEBUG_FRAME_LOG: nextLogFrame() type: "));
+      Serial.print(frame.type);
+      Serial.print(F(", nextIndex: "));
+      Serial.println(reader.nextIndex);
+    #endif
+    return true;
+  }
+  return false;
+}
+
+boolean AbstractFrameLog::nextLogEntry(LogEntry &entry) {
+  LogFrame frame;
+  memset(&entry.data, 0x0, sizeof(LogData));
+  if (! nextLogFrame(frame, entry.data.payload, sizeof(LogData))) return false;
+  entry.timestamp = frame.timestamp;
+  entry.type = frame.type;
+  return true;
+}
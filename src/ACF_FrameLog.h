@@ -0,0 +1,271 @@
+#ifndef ACF_FRAME_LOG_H_INCLUDED
+  #define ACF_FRAME_LOG_H_INCLUDED
+
+  #include <ACF_Logging.h>
+
+  // Frame layout on the store: [size][timestamp][type][payload ...][size]
+  #define LOG_FRAME_OVERHEAD     (sizeof(uint8_t) + sizeof(Timestamp) + sizeof(T_LogDataType_ID) + sizeof(uint8_t))
+  // Compact keyframes add a flag byte and the delta (varint, up to 5 bytes) to the timestamp:
+  #define LOG_FRAME_MAX_OVERHEAD (LOG_FRAME_OVERHEAD + 6)
+  #define LOG_FRAME_MAX_SIZE     0xFE
+  #define LOG_FRAME_MAX_PAYLOAD  (LOG_FRAME_MAX_SIZE - LOG_FRAME_MAX_OVERHEAD)
+
+  /*
+   * Header of a log frame as returned by AbstractFrameLog::nextLogFrame().
+   */
+  struct LogFrame {
+    Timestamp timestamp;
+    T_LogDataType_ID type;
+    uint8_t length;  // number of payload bytes
+  };
+
+  /*
+   * Header of a log frame as found on the store.
+   */
+  struct LogFrameHeader {
+    uint8_t size;          // total size of the frame
+    uint8_t headerSize;    // number of bytes preceding the payload
+    boolean keyframe;      // true if the frame holds the full timestamp
+    Timestamp timestamp;   // keyframes only
+    Timestamp delta;       // compact format only: timestamp minus the timestamp of the preceding frame
+    T_LogDataType_ID type;
+  };
+
+
+  /*
+   * A circular log with variable-length records ("frames"), so an entry only takes the space of its actual payload
+   * (plus LOG_FRAME_OVERHEAD bytes) and an occasional entry can be much larger than LOG_DATA_PAYLOAD_SIZE.
+   * Logging is done to a ACF_Store::AbstractStore.
+   *
+   * The log structure is as follows:
+   *
+   * - magic number
+   * - ringSize (=total number of bytes of the ring buffer; used to detect changes => reset)
+   * - Ring buffer (uint8_t[ringSize]) of frames: [size][timestamp][type][payload ...][size]
+   *
+   * The size byte at both ends of a frame enables walking the ring forwards and backwards. A frame never wraps around the end of
+   * the ring: if it doesn't fit, a wrap marker is written and the frame starts at offset 0. All the bytes between the end of the most recent
+   * frame (the log head) and the oldest frame (the log tail) are 0x0, thus init() finds the head by following the frame sizes from offset 0
+   * and the tail as the first non-zero byte behind the head. Unlike the slots of AbstractLog, the frames must be walked (reading 1 byte
+   * per frame) at init().
+   *
+   * The readers work exactly as the ones of AbstractLog; nextLogEntry() returns the payload truncated or zero-padded to LogData.
+   *
+   * Compact format (keyframeInterval > 0): consecutive timestamps are usually only a few seconds apart, thus a frame stores the
+   * difference to the timestamp of its preceding frame as a varint, mostly 1 byte instead of 4:
+   *
+   * - delta frame: [size][varint delta][type][payload ...][size]          (delta >= 1 because timestamps are unique and ascending)
+   * - keyframe:    [size][0x0][varint delta][timestamp][type][payload ...][size]
+   *
+   * Every keyframeInterval-th frame is a keyframe, and the log always holds at least one. Full timestamps are rebuilt by seeking the
+   * nearest keyframe and adding up deltas; the most recent timestamp is kept in RAM, so the reader for the most recent entries just
+   * subtracts deltas. Keyframes also store their delta, so the oldest frames remain decodable after their keyframe has been removed.
+   */
+  class AbstractFrameLog {
+
+    public:
+
+      /*
+       * @param store physical store to use for persistent storage; cannot be null.
+       * @param keyframeInterval 0 = every frame holds its full timestamp, else use the compact format with a keyframe every keyframeInterval frames.
+       *        The two formats use different magic numbers, thus switching between them clears the log; the interval itself can be changed.
+       */
+      AbstractFrameLog(AbstractStore *store, uint8_t keyframeInterval = 0);
+
+      /**
+       * Initialise in-memory log-managment structures from the log frames found in the store.
+       * This is typically performed after an Arduino board-reset.
+       * If the size of the ring buffer is found to be different from the previous run, then the
+       * log is cleared and a message is logged to record the change in size.
+       */
+      virtual void init();
+
+      /**
+       * Clear all log entries on the store and reset in-memory log-managment structures.
+       */
+      virtual void clear();
+
+      /*
+       * The timestamp generator for this log.
+       */
+      LogTime logTime = LogTime();
+
+      /*
+       * Returns the number of bytes available for frames.
+       */
+      uint16_t ringSize();
+
+      /*
+       * Returns current number of log entries (= frames).
+       */
+      uint16_t currentLogEntries();
+
+      /*
+       * Returns number of bytes taken by the current log entries.
+       */
+      uint16_t currentLogBytes();
+
+      /*
+       * Log a message.
+       * Note: this function is purely virtual. It has not been implemented in order to leave the definition of
+       *       the message data structure to the consumers of this library. In its implementation, use addLogFrame()
+       *       to create of a new log entry.
+       */
+      virtual Timestamp logMessage(T_Message_ID id, T_Message_Param param1, T_Message_Param param2) = 0;
+
+      /*
+       * Initialises the reader to return at most maxResults of the most recent entries.
+       * The entries are returned in decending order by timestamp (most recent first).
+       *
+       * @param maxResults indicates how many log entries to return as a maximum; the special value 0 means to return all log entries
+       * Note: the reader is only valid as long the log is not being modified.
+       */
+      void readMostRecentLogEntries(uint16_t maxResults);
+
+      /*
+       * Initialises the reader to return all the log entries that have not yet been notified to the client(s).
+       * The entries are returned in ascending order by timestamp (oldest unnotified entry first).
+       * Note: the reader is only valid as long the log is not being modified.
+       */
+      void readUnnotifiedLogEntries();
+
+      /*
+       * Retuns the "next" entry of the log ("next" can be the next or the previous, depending on the reader kind).
+       * Precondition: readMostRecentLogEntries() or readUnnotifiedLogEntries() was called and the log has not been modified since.
+       *
+       * @param payload buffer receiving at most maxLength payload bytes (the payload is truncated if it is longer)
+       * @return true means the parameter 'frame' contains the header of the next frame, false means 'frame' has no defined semantics (i.e. after the last entry has been returned or if the log has been modified)
+       */
+      boolean nextLogFrame(LogFrame &frame, uint8_t *payload, uint8_t maxLength);
+
+      /*
+       * Same as nextLogFrame() but returns the entry as LogEntry; its data is truncated or filled with 0x0 to sizeof(LogData).
+       */
+      boolean nextLogEntry(LogEntry &entry);
+
+    protected:
+      /*
+       * The physical storage of the log.
+       */
+      AbstractStore *store;
+
+      /*
+       * The number of bytes of the ring buffer.
+       */
+      uint16_t ringBytes;
+
+      /*
+       * Compact format only: number of frames from one keyframe to the next, else 0.
+       */
+      uint8_t keyframeInterval;
+
+	  /*
+	   * Returns the "magic number" on the store used to identify whether the log area in the storage has been initialised.
+	   */
+	  uint8_t magicNumber();
+
+  #ifdef UNIT_TEST  // make available for unit tests
+    public:
+  #endif
+      /*
+       * Ring offset where the next frame will be written; the byte there is always 0x0.
+       */
+      uint16_t logHeadIndex = 0;
+      /*
+       * Ring offset of the oldest frame (equals logHeadIndex if the log is empty).
+       */
+      uint16_t logTailIndex = 0;
+      /*
+       * Non-concurrent reader (=cursor) to iterate over log entries; nextIndex is a ring offset.
+       */
+      LogReader reader;
+
+  #ifdef UNIT_TEST
+    protected:
+  #endif
+      /*
+       * Ring offset of the wrap marker ending the frames between the tail and the end of the ring, or ringBytes if there is none.
+       */
+      uint16_t wrapIndex;
+
+      /*
+       * Number of frames.
+       */
+      uint16_t entries = 0;
+
+      /*
+       * Ring offset of the oldest unnotified frame (equals logHeadIndex if there is none) and number of unnotified frames.
+       */
+      uint16_t unnotifiedIndex = 0;
+      uint16_t unnotifiedEntries = 0;
+
+      /*
+       * Timestamp of the most recent frame.
+       */
+      Timestamp lastTimestamp = 0L;
+
+      /*
+       * Compact format only: number of keyframes in the log and number of frames added after the most recent keyframe.
+       */
+      uint16_t keyframes = 0;
+      uint8_t framesSinceKeyframe = 0;
+
+      /*
+       * Timestamp of the frame preceding reader.nextIndex in reading direction (compact format only).
+       */
+      Timestamp readerTimestamp;
+
+      /*
+       * Calculates the byte-offset within the store for the given ring offset.
+       */
+      uint16_t ringOffset(uint16_t index);
+
+      /*
+       * Returns the ring offset of the frame following the frame at index with the given size.
+       */
+      uint16_t nextFrameIndex(uint16_t index, uint8_t size);
+
+      /*
+       * Returns the ring offset of the frame preceding the frame (or the log head) at index.
+       */
+      uint16_t previousFrameIndex(uint16_t index);
+
+      /*
+       * Reads the header of the frame at the given ring offset.
+       */
+      void readFrameHeader(uint16_t index, LogFrameHeader &header);
+
+      /*
+       * Reads at most maxLength payload bytes of the frame at the given ring offset and sets the length of the frame.
+       */
+      void readFramePayload(uint16_t index, LogFrameHeader &header, LogFrame &frame, uint8_t *payload, uint8_t maxLength);
+
+      /*
+       * Returns the full timestamp of the frame at the given ring offset, decoded from the nearest keyframe (compact format).
+       */
+      Timestamp frameTimestamp(uint16_t index);
+
+      /*
+       * Removes as many of the oldest frames as needed to write a frame of the given size at the log head; moves the log head
+       * to offset 0 if the frame doesn't fit before the end of the ring.
+       */
+      void makeRoom(uint8_t size);
+
+      /*
+       * Sets len bytes starting at the given ring offset to 0x0; the first byte is cleared last.
+       */
+      void clearBytes(uint16_t index, uint16_t len);
+
+      /**
+       * Removes the oldest frame from the log.
+       */
+      void removeTailFrame();
+
+      /**
+       * Creates and adds a frame at the current logHead position, making room by removing the oldest frames where necessary.
+       * @param len number of payload bytes, at most LOG_FRAME_MAX_PAYLOAD
+       */
+      Timestamp addLogFrame(T_LogDataType_ID type, const void *payload, uint8_t len);
+  };
+
+#endif
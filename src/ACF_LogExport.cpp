@@ -0,0 +1,24 @@
+#include <ACF_LogExport.h>
+
+
+template <class T_LogTime>
+uint16_t exportLog(AbstractLogT<T_LogTime> &log, LogCursor &cursor, Print &out) {
+  typedef typename AbstractLogT<T_LogTime>::T_LogEntry T_LogEntry;
+  const uint8_t header[] = {LOG_EXPORT_MAGIC_NUMBER, LOG_EXPORT_VERSION, sizeof(T_LogEntry().timestamp), sizeof(T_LogEntry)};
+  out.write(header, sizeof(header));
+  
+  T_LogEntry entries[LOG_EXPORT_FRAME_ENTRIES];
+  uint16_t total = 0;
+  uint8_t n;
+  while ((n = log.nextLogEntries(cursor, entries, LOG_EXPORT_FRAME_ENTRIES)) > 0) {
+    out.write(n);
+    out.write((const uint8_t *) entries, n * sizeof(T_LogEntry));
+    total += n;
+  }
+  out.write((uint8_t) 0);
+  return total;
+}
+
+// the two kinds of logs (see ACF_Logging.h):
+template uint16_t exportLog(AbstractLogT<LogTime> &log, LogCursor &cursor, Print &out);
+template uint16_t exportLog(AbstractLogT<PreciseLogTime> &log, LogCursor &cursor, Print &out);
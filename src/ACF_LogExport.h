@@ -0,0 +1,33 @@
+#ifndef ACF_LOG_EXPORT_H_INCLUDED
+  #define ACF_LOG_EXPORT_H_INCLUDED
+
+  #include <ACF_Logging.h>
+
+  // Define this symbol for the whole build (compiler flag, e.g. -DLOG_EXPORT_FRAME_ENTRIES=16) to have a different number of entries per
+  // frame (= RAM buffer on the stack, in entries); defining it in a sketch has no effect since exportLog() is compiled in ACF_LogExport.cpp:
+  #ifndef LOG_EXPORT_FRAME_ENTRIES
+    #define LOG_EXPORT_FRAME_ENTRIES 8
+  #endif
+  static_assert(LOG_EXPORT_FRAME_ENTRIES >= 1 && LOG_EXPORT_FRAME_ENTRIES <= 255, "LOG_EXPORT_FRAME_ENTRIES: frame count is 1 byte");
+
+  #define LOG_EXPORT_MAGIC_NUMBER 0xAC
+  #define LOG_EXPORT_VERSION      1
+
+  /*
+   * Writes the log entries returned by the cursor to out in a compact binary format, without formatting any of them:
+   *
+   * - header: [magic number][version][sizeof(timestamp)][sizeof(log entry)]
+   * - frames: [n][n log entries exactly as stored] with 1 <= n <= LOG_EXPORT_FRAME_ENTRIES
+   * - end:    [0]
+   *
+   * The entries are read from the store in blocks of consecutive slots (see AbstractLogT::nextLogEntries()) and each frame is
+   * written to out in one call. The receiver decodes the entries with the LogEntry / PreciseLogEntry layout of the board.
+   *
+   * Example: log.readMostRecentLogEntries(cursor, 0) exports the whole log, newest first; log.readRange(cursor, 0, 0xFFFFFFFF)
+   * exports it oldest first.
+   *
+   * @return the number of entries written
+   */
+  template <class T_LogTime> uint16_t exportLog(AbstractLogT<T_LogTime> &log, LogCursor &cursor, Print &out);
+
+#endif
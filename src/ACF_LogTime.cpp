@@ -1,4 +1,3 @@
-#include <assert.h>
 #include <ACF_LogTime.h>
 
 // #define DEBUG_LOG_TIME
@@ -6,9 +5,24 @@
 #define ASCII_0 48  // char(48)
 
 
+#if TIMESTAMP_ID_BITS > 6
+  #define ID_DIGITS 3
+#else
+  #define ID_DIGITS 2
+#endif
+
+
+LogTime::LogTime(boolean blocking) {
+  this->blocking = blocking;
+}
+
+void LogTime::setClock(Clock *clock) {
+  this->clock = clock;
+}
+
 RawLogTime LogTime::raw() {
-  uint32_t ms = millis();
-  RawLogTime t = {timeBase_sec + (ms / 1000L), (uint16_t) (ms % 1000L)};
+  TimeMillis64 ms = clock->millis64();
+  RawLogTime t = {timeBase_sec + (uint32_t) (ms / 1000L), (uint16_t) (ms % 1000L)};
   return t;
 }
 
@@ -19,17 +33,22 @@ Timestamp LogTime::timestamp() {
     timestampCount = 0;
     last_sec = t.sec;
   } else {
+    // same second, or a second borrowed earlier (not blocking) that the clock hasn't reached yet:
     timestampCount++;
-    if (timestampCount == 16) {
-      // wait for the next full second to start (with an added safety margin of 1):
-      delay(1000 - t.ms + 1);
-      t = raw();
-      assert(t.sec > last_sec);
+    if (timestampCount == TIMESTAMP_IDS) {
+      if (blocking) {
+        // wait for the next full second to start (with an added safety margin of 1):
+        delay(1000 - t.ms + 1);
+        t = raw();
+        // a clock that doesn't move with delay() (FakeClock) is treated like not blocking:
+        last_sec = t.sec > last_sec ? t.sec : last_sec + 1;
+      } else {
+        last_sec++;  // borrow the next second
+      }
       timestampCount = 0;
-      last_sec = t.sec;
     }
   }
-  Timestamp ts = t.sec << TIMESTAMP_ID_BITS | timestampCount;
+  Timestamp ts = last_sec << TIMESTAMP_ID_BITS | timestampCount;
   #ifdef DEBUG_LOG_TIME
     Serial.print(F("DEBUG_LOG_TIME: Timestamp "));
     char buf[MAX_TIMESTAMP_STR_LEN];
@@ -41,7 +60,7 @@ Timestamp LogTime::timestamp() {
 
 void LogTime::adjust(Timestamp mostRecent) {
   uint32_t mostRecent_sec = mostRecent >> TIMESTAMP_ID_BITS;
-  uint32_t current_sec = millis() / 1000L;
+  uint32_t current_sec = clock->millis64() / 1000L;
   if (mostRecent_sec >= current_sec) {
     timeBase_sec = mostRecent_sec + 1; // continue at the "next" second
   } else {
@@ -57,17 +76,95 @@ void LogTime::reset() {
 }
 
 
+char *LogTime::format(Timestamp t, char *buf) {
+  return formatTimestamp(t, buf);
+}
+
+
+void PreciseLogTime::setClock(Clock *clock) {
+  this->clock = clock;
+}
+
+PreciseTimestamp PreciseLogTime::raw() {
+  return timeBase_ms + clock->millis64();
+}
+
+PreciseTimestamp PreciseLogTime::timestamp() {
+  PreciseTimestamp ts = raw();
+  if (ts <= last) {
+    ts = last + 1;  // borrow the next millisecond
+  }
+  last = ts;
+  #ifdef DEBUG_LOG_TIME
+    Serial.print(F("DEBUG_LOG_TIME: PreciseTimestamp "));
+    char buf[MAX_PRECISE_TIMESTAMP_STR_LEN];
+    Serial.println(formatPreciseTimestamp(ts, buf));
+  #endif
+  return ts;
+}
+
+void PreciseLogTime::adjust(PreciseTimestamp mostRecent) {
+  reset();
+  if (mostRecent >= raw()) {
+    timeBase_ms = mostRecent + 1; // continue at the "next" millisecond
+  }
+}
+
+void PreciseLogTime::reset() {
+  timeBase_ms = 0;
+  last = 0;
+}
+
+char *PreciseLogTime::format(PreciseTimestamp t, char *buf) {
+  return formatPreciseTimestamp(t, buf);
+}
+
+
+/*
+ * "00" .. "99": the formatters below convert two digits per division by 100 rather than one digit per division by 10.
+ */
+static const char DIGIT_PAIRS[201] PROGMEM =
+  "0001020304050607080910111213141516171819"
+  "2021222324252627282930313233343536373839"
+  "4041424344454647484950515253545556575859"
+  "6061626364656667686970717273747576777879"
+  "8081828384858687888990919293949596979899";
+
+/*
+ * Writes the given number of decimal digits of value (with leading zeros) into the buf, right to left; returns the remaining value.
+ */
+static uint32_t formatDigits(uint32_t value, char *buf, uint8_t digits) {
+  char *p = buf + digits;
+  while (digits >= 2) {
+    const uint8_t pair = value % 100;
+    value /= 100;
+    *--p = pgm_read_byte(DIGIT_PAIRS + 2 * pair + 1);
+    *--p = pgm_read_byte(DIGIT_PAIRS + 2 * pair);
+    digits -= 2;
+  }
+  if (digits) {
+    *--p = ASCII_0 + value % 10;
+    value /= 10;
+  }
+  return value;
+}
+
 char *formatTimestamp(Timestamp t, char s[MAX_TIMESTAMP_STR_LEN]) {
-  uint32_t sec = t >> TIMESTAMP_ID_BITS;
-  uint8_t timestampCount = t % 16;
+  formatDigits(t >> TIMESTAMP_ID_BITS, s, 11 - ID_DIGITS);
+  s[11 - ID_DIGITS] = '.';
+  formatDigits(t & TIMESTAMP_ID_MASK, s + 12 - ID_DIGITS, ID_DIGITS);
   s[12] = '\0';
-  s[11] = ASCII_0 + timestampCount % 10;
-  s[10] = ASCII_0 + timestampCount / 10;
-  s[9] = '.';
-  for(int16_t i = 8; i >= 0; i--) {
-    s[i] = ASCII_0 + sec % 10;
-    sec /= 10;
-  }
   return s;
 }
 
+
+char *formatPreciseTimestamp(PreciseTimestamp t, char s[MAX_PRECISE_TIMESTAMP_STR_LEN]) {
+  const PreciseTimestamp sec = t / 1000;
+  // 10 digits of seconds exceed 32 bits: split into 5 + 5 digits
+  formatDigits((uint32_t) ((sec / 100000) % 100000), s, 5);
+  formatDigits((uint32_t) (sec % 100000), s + 5, 5);
+  s[10] = '.';
+  formatDigits((uint32_t) (t % 1000), s + 11, 3);
+  s[14] = '\0';
+  return s;
+}
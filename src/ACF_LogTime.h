@@ -2,6 +2,7 @@
   #define ACF_LOGTIME_H_INCLUDED
   
   #include <Arduino.h>
+  #include <ACF_Clock.h>
 
    
   /**
@@ -12,11 +13,29 @@
    *                   - the log reset may have happened several board resets earlier
    *                   - up to 16 timestamps can be generated within one second
    * The timestamp() function creates ascending values in strong monotony, even across board resets.
+   * The split can be changed via the build flag TIMESTAMP_ID_BITS, e.g. 24 + 8 bits: about 194 days, 256 timestamps per second.
    */
   typedef uint32_t Timestamp;
   
-  #define TIMESTAMP_ID_BITS   4
+  // Define this symbol for the whole build (compiler flag, e.g. -DTIMESTAMP_ID_BITS=8) to have a different number of identifier bits
+  // (4..8); defining it in a sketch has no effect on ACF_LogTime.cpp and leaves the two disagreeing on the split. Logs written with a
+  // different split must be cleared:
+  #ifndef TIMESTAMP_ID_BITS
+    #define TIMESTAMP_ID_BITS 4
+  #endif
+  #if TIMESTAMP_ID_BITS < 4 || TIMESTAMP_ID_BITS > 8
+    #error "TIMESTAMP_ID_BITS must be 4..8"
+  #endif
+  
+  #define TIMESTAMP_IDS       (1 << TIMESTAMP_ID_BITS)   // number of timestamps per second
+  #define TIMESTAMP_ID_MASK   (TIMESTAMP_IDS - 1)
   #define UNDEFINED_TIMESTAMP 0L
+
+  /**
+   * Millisecond timestamps for high-frequency logging (see PreciseLogTime): milliseconds since last log reset.
+   * The timestamp() function creates ascending values in strong monotony, even across board resets.
+   */
+  typedef uint64_t PreciseTimestamp;
   
   struct RawLogTime {
     uint32_t sec; // seconds since log was last reset or since last board reset, which ever happened earlier
@@ -28,10 +47,22 @@
 
     public:
       
+      /*
+       * The timestamp type created by this class.
+       */
+      typedef Timestamp TimestampType;
+      
       /**
-       * Returns a unique timestamp. A maximum of 16 timestamps can be generated within the same second.
+       * @param blocking false = timestamp() never delays: once the identifiers of a second are used up, it continues with the
+       *        identifiers of the next second ("borrowing" from the future). The timestamps remain unique and ascending; they
+       *        run ahead of the clock for the duration of a burst and catch up once the clock has passed the borrowed seconds.
+       */
+      LogTime(boolean blocking = true);
+      
+      /**
+       * Returns a unique timestamp. A maximum of 16 (TIMESTAMP_IDS) timestamps can be generated within the same second.
        * 
-       * Note: this function will delay() until the next second starts (where millis() % 1000 == 0) if the 
+       * Note: if blocking, this function will delay() until the next second starts (where millis() % 1000 == 0) if the 
        * maximum of 16 timestamps in a given second is exceeded.
        */
       Timestamp timestamp();
@@ -40,6 +71,11 @@
        * Returns the raw log time in internal format.
        */
       RawLogTime raw();
+      
+      /**
+       * Replaces the clock (by default the systemClock()), e.g. by a FakeClock for tests.
+       */
+      void setClock(Clock *clock);
     
       /**
        * Calculates a time offset from the mostRecent log-entry timestamp (which usually stems from a 
@@ -51,30 +87,115 @@
        * Resets the offset to 0 which means that log time and millis() coincide again in terms of seconds elapsed.
        */
       void reset();
+      
+      /**
+       * Same as formatTimestamp().
+       */
+      static char *format(Timestamp t, char *buf);
 
     protected:
       
+      /*
+       * The source of time.
+       */
+      Clock *clock = systemClock();
+      
+      /*
+       * False if timestamp() borrows the identifiers of the next second rather than waiting for it.
+       */
+      boolean blocking;
+      
       /*
        * The value (in seconds) added to Arduino board millis().
        */
       uint32_t timeBase_sec = 0L;
       
       /*
-       * The (adjusted) seconds of time when a the last timestamp was issued.
+       * The (adjusted) seconds of time when a the last timestamp was issued; can be ahead of the time if not blocking.
        */
       uint32_t last_sec = 0L;
       
       /*
        * The ID count of the last issued timestamp.
        */
-      uint8_t timestampCount = 0;
+      uint16_t timestampCount = 0;
+  };
+
+
+  /*
+   * Timestamp generator with millisecond resolution: there is no limit on the number of timestamps per second. If more than one
+   * timestamp is requested within the same millisecond, the next millisecond is "borrowed" (never delays).
+   */
+  class PreciseLogTime {
+
+    public:
+      
+      /*
+       * The timestamp type created by this class.
+       */
+      typedef PreciseTimestamp TimestampType;
+      
+      /**
+       * Returns a unique timestamp.
+       */
+      PreciseTimestamp timestamp();
+      
+      /**
+       * Returns the milliseconds since the log was last reset or since the last board reset, which ever happened earlier.
+       */
+      PreciseTimestamp raw();
+      
+      /**
+       * Replaces the clock (by default the systemClock()), e.g. by a FakeClock for tests.
+       */
+      void setClock(Clock *clock);
+    
+      /**
+       * Calculates a time offset from the mostRecent log-entry timestamp (which usually stems from a 
+       * log entry prior to board reset or power down).
+       */
+      void adjust(PreciseTimestamp mostRecent);
+      
+      /**
+       * Resets the offset to 0 which means that log time and millis() coincide again.
+       */
+      void reset();
+      
+      /**
+       * Same as formatPreciseTimestamp().
+       */
+      static char *format(PreciseTimestamp t, char *buf);
+
+    protected:
+      
+      /*
+       * The value (in milliseconds) added to Arduino board millis().
+       */
+      PreciseTimestamp timeBase_ms = 0;
+      
+      /*
+       * The last issued timestamp; can be ahead of the time.
+       */
+      PreciseTimestamp last = 0;
+      
+      /*
+       * The source of time.
+       */
+      Clock *clock = systemClock();
   };
 
 
   #define MAX_TIMESTAMP_STR_LEN 13
   /**
    * Returns the timestamp in a 13-character dotted notation, terminated by '\0': sssssssss.cc  (s = seconds: 2^28 = 268435456 (9 digits), cc = count: 0..15 (2 digits))
+   * With more than 6 identifier bits the notation is ssssssss.ccc (2^25 = 33554432 (8 digits), ccc = count: 0..255).
    */
   char *formatTimestamp(Timestamp t, char buf[MAX_TIMESTAMP_STR_LEN]);
   
+  #define MAX_PRECISE_TIMESTAMP_STR_LEN 15
+  /**
+   * Returns the precise timestamp in a 15-character dotted notation, terminated by '\0': ssssssssss.mmm  (s = seconds (10 digits), mmm = milliseconds)
+   */
+  char *formatPreciseTimestamp(PreciseTimestamp t, char buf[MAX_PRECISE_TIMESTAMP_STR_LEN]);
+  
 #endif
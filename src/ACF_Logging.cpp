@@ -1,5 +1,6 @@
 #include <ACF_Logging.h>
 #include <ACF_Messages.h>
+#include <ACF_CRC.h>
 
 // #define DEBUG_LOG
 
@@ -9,43 +10,82 @@
  * very first time *cannot be assumed to be 0x0* !!
  */
 const uint8_t MAGIC_NUMBER = 199;
+const uint8_t PRECISE_MAGIC_NUMBER = 195;  // AbstractPreciseLog (different entry layout)
+const uint8_t CHECKPOINT_MAGIC_NUMBER = 198;  // with checkpoint (see constructor)
+const uint8_t PRECISE_CHECKPOINT_MAGIC_NUMBER = 194;
 
 #define MAGIC_NUMBER_SIZE sizeof(uint8_t)
 #define NUM_SLOTS_SIZE sizeof(uint16_t)
 #define LOG_ENTRIES_OFFSET (MAGIC_NUMBER_SIZE + NUM_SLOTS_SIZE)
-#define LOG_ENTRY_SIZE sizeof(LogEntry)
+#define LOG_ENTRY_SIZE sizeof(T_LogEntry)
+#define CHECKPOINT_SIZE sizeof(LogCheckpoint)
+#define ENTRY_MAGIC_NUMBER (sizeof(T_Timestamp) == sizeof(Timestamp) \
+    ? (checkpointed ? CHECKPOINT_MAGIC_NUMBER : MAGIC_NUMBER) : (checkpointed ? PRECISE_CHECKPOINT_MAGIC_NUMBER : PRECISE_MAGIC_NUMBER))
+/*
+ * Sequence numbers wrap around (2^32): a precedes b if the distance from b to a, taken as signed, is negative.
+ */
+#define SEQ_BEFORE(a, b) ((int32_t) ((a) - (b)) < 0)
 
 
-AbstractLog::AbstractLog(AbstractStore *store) {
+template <class T_LogTime>
+AbstractLogT<T_LogTime>::AbstractLogT(AbstractStore *store, bool checkpoint) {
   ASSERT(store != NULL, "constructor:store");
   this->store = store;
-  logEntrySlots = (store->size() - LOG_ENTRIES_OFFSET) / LOG_ENTRY_SIZE;
+  checkpointed = checkpoint && ! store->expiringMedia();
+  logEntrySlots = (store->size() - LOG_ENTRIES_OFFSET - (checkpointed ? CHECKPOINT_SIZE : 0)) / LOG_ENTRY_SIZE;
+}
+
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::setIndex(T_Timestamp *buffer, uint16_t size) {
+  ASSERT(buffer != NULL && size > 0, "setIndex");
+  indexBuffer = buffer;
+  indexStride = (logEntrySlots + size - 1) / size;
+  indexSize = (logEntrySlots + indexStride - 1) / indexStride;
 }
 
-uint8_t AbstractLog::magicNumber() {
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::rebuildIndex() {
+  for (uint16_t i = 0; i < indexSize; i++) {
+    indexBuffer[i] = entryTimestamp(i * indexStride);
+  }
+}
+
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::updateIndex(uint16_t slot, T_Timestamp ts) {
+  if (indexBuffer != NULL && slot % indexStride == 0) {
+    indexBuffer[slot / indexStride] = ts;
+  }
+}
+
+template <class T_LogTime>
+uint8_t AbstractLogT<T_LogTime>::magicNumber() {
 	return store->read8(0);
 }
 
-uint16_t AbstractLog::entryOffset(uint16_t index) {
+template <class T_LogTime>
+uint16_t AbstractLogT<T_LogTime>::entryOffset(uint16_t index) {
   return LOG_ENTRIES_OFFSET + index * LOG_ENTRY_SIZE;
 }
 
-uint16_t AbstractLog::maxLogEntries() {
+template <class T_LogTime>
+uint16_t AbstractLogT<T_LogTime>::maxLogEntries() {
   return logEntrySlots - 1;
 }
 
-uint16_t AbstractLog::currentLogEntries() {
+template <class T_LogTime>
+uint16_t AbstractLogT<T_LogTime>::currentLogEntries() {
   if (logHeadIndex == logTailIndex) return 0;
   if (logHeadIndex > logTailIndex) return logHeadIndex - logTailIndex;
   return logEntrySlots - (logTailIndex - logHeadIndex);  // (logTailIndex - logHeadIndex) always differs by at least 1
 }
 
-void AbstractLog::clear() {
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::clear() {
   #ifdef DEBUG_LOG
     Serial.print(F("DEBUG_LOG: clear() [new] log size: "));
     Serial.println(logEntrySlots);
   #endif
-  store->update8(0, MAGIC_NUMBER);
+  store->update8(0, ENTRY_MAGIC_NUMBER);
   store->update(MAGIC_NUMBER_SIZE, logEntrySlots);
   // clear
   for (uint16_t i = 0; i < logEntrySlots; i++) {
@@ -54,13 +94,15 @@ void AbstractLog::clear() {
   logTime.reset();
   logHeadIndex = 0;
   logTailIndex = 0;
+  headSeq += logEntrySlots;      // invalidates all cursors
+  lastNotifiedSeq = headSeq - 1; // = the one before the current entry at index 0
   // write a log message so there is always at least one log entry:
   logMessage(static_cast<T_Message_ID>(ACF_Msg::LOG_INIT), 0, 0);
-  lastNotifiedLogEntryIndex = logEntrySlots - 1; // = the one before the current entry at index 0
 }
 
 
-void AbstractLog::init() {
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::init() {
   //
   // Check if the number of log entries has changed (typically by changing from unit tests to production):
   //
@@ -70,7 +112,7 @@ void AbstractLog::init() {
     Serial.print(F("DEBUG_LOG: init() stored log size: "));
     Serial.println(oldMaxLogEntries);
   #endif
-  const bool wrongMagicNumber = magicNumber() != MAGIC_NUMBER;
+  const bool wrongMagicNumber = magicNumber() != ENTRY_MAGIC_NUMBER;
   const bool logEntriesChanged = oldMaxLogEntries != logEntrySlots;
   if (wrongMagicNumber || logEntriesChanged) {
     clear();
@@ -82,84 +124,199 @@ void AbstractLog::init() {
     return;
   }
   
-  LogEntry entry;
-  uint16_t mostRecentIndex = logEntrySlots;  // index of the most recent log entry (value is out of range => assert later that it was updated!)
-  Timestamp mostRecentTimestamp = 0L;        // timestamp of the  most recent log entry
-  logHeadIndex = logEntrySlots;              // value is out of range => assert later that logHeadIndex was updated!
-  
-  // find log head (= first empty log entry)
-  for (uint16_t i = 0; i < logEntrySlots ; i++) {
-    store->read(entryOffset(i), entry);
-    
-    if (entry.timestamp == 0L) {
-      logHeadIndex = i;
-      mostRecentIndex = (logEntrySlots + logHeadIndex - 1) % logEntrySlots;  // (logHeadIndex -1) can be negative => % function returns 0 ... !! => ensure always >= 0
-      if(i == 0) {
-        // if the head (= empty entry) is the very first entry of the array, then the most recent one is the very last one:
-        LogEntry mostRecentEntry;
-        store->read(entryOffset(mostRecentIndex), mostRecentEntry);      
-        mostRecentTimestamp = mostRecentEntry.timestamp;
-      }
-      break;
-    } 
-    mostRecentTimestamp = entry.timestamp;
+  headSeq += logEntrySlots;  // invalidates all cursors
+  if (checkpointed && restoreCheckpoint()) {
+    if (indexBuffer != NULL) rebuildIndex();
+    logTime.adjust(entryTimestamp((logEntrySlots + logHeadIndex - 1) % logEntrySlots));
+    #ifdef DEBUG_LOG
+      Serial.print(F("DEBUG_LOG: init() from checkpoint, entries: "));
+      Serial.println(currentLogEntries());
+    #endif
+    return;
   }
   
-  ASSERT(mostRecentIndex != logEntrySlots, "initLog:index");
-  lastNotifiedLogEntryIndex = mostRecentIndex;
+  // find log head (= the single empty log entry) by binary search, see findLogHead():
+  logHeadIndex = findLogHead();
+  if (logHeadIndex == logEntrySlots) {
+    logHeadIndex = 0;  // no empty slot: the board was reset during a batch that ended in the last slot
+  }
+  if (entryTimestamp(logHeadIndex) != 0L) {
+    clearLogEntry(logHeadIndex);  // the board was reset during a batch, see beginBatch()
+  }
+  const uint16_t mostRecentIndex = (logEntrySlots + logHeadIndex - 1) % logEntrySlots;  // (logHeadIndex -1) can be negative => % function returns 0 ... !! => ensure always >= 0
+  const T_Timestamp mostRecentTimestamp = entryTimestamp(mostRecentIndex);
   
-  ASSERT(logHeadIndex != logEntrySlots, "initLog:head");
+  lastNotifiedSeq = headSeq - 1;  // = mostRecentIndex
   
   ASSERT(mostRecentTimestamp != 0L, "initLog:timestamp");
   logTime.adjust(mostRecentTimestamp);
   
-  logTailIndex = logEntrySlots;    // value is out of range => assert later that logTailIndex was updated!
-  for (uint16_t i = 1; i < logEntrySlots ; i++) {
-    uint16_t index = (logHeadIndex + i) % logEntrySlots;
-    store->read(entryOffset(index), entry);
-    if (entry.timestamp != 0L) {
-      logTailIndex = index;
-      break;
-    }
+  // the oldest entry immediately follows the head once the log has wrapped around, else the log starts at slot 0:
+  logTailIndex = (logHeadIndex + 1) % logEntrySlots;
+  if (entryTimestamp(logTailIndex) == 0L) {
+    logTailIndex = 0;
   }
-  ASSERT(logTailIndex != logEntrySlots , "initLog:tail");
+  ASSERT(logTailIndex != logHeadIndex && entryTimestamp(logTailIndex) != 0L, "initLog:tail");
+  if (indexBuffer != NULL) rebuildIndex();
+  writeCheckpoint();
   #ifdef DEBUG_LOG
 	Serial.print(F("           init() entries: "));
 	Serial.println(currentLogEntries());
   #endif
 }
 
-void AbstractLog::clearLogEntry(uint16_t index) {
-  reader.valid = false;
-  uint16_t offset = entryOffset(index);
-  for (uint16_t i = 0; i < LOG_ENTRY_SIZE ; i++) {
-    store->update8(offset + i, 0);
+template <class T_LogTime>
+typename AbstractLogT<T_LogTime>::T_Timestamp AbstractLogT<T_LogTime>::entryTimestamp(uint16_t index) {
+  T_Timestamp ts;
+  store->read(entryOffset(index) + offsetof(T_LogEntry, timestamp), ts);
+  return ts;
+}
+
+/*
+ * The entries from slot 0 up to the head were written in this order, hence their timestamps ascend from the timestamp in slot 0.
+ * The head itself is empty, and every slot beyond the head is either empty or holds an older entry from the previous
+ * round through the ring. The predicate "timestamp != 0 && timestamp >= timestamp of slot 0" therefore holds for all the slots
+ * before the head and for none from the head onwards, so the head is found with log2(logEntrySlots) timestamp reads.
+ */
+template <class T_LogTime>
+uint16_t AbstractLogT<T_LogTime>::findLogHead() {
+  const T_Timestamp first = entryTimestamp(0);
+  if (first == 0L) return 0;
+  uint16_t lo = 1;               // invariant: all slots < lo satisfy the predicate
+  uint16_t hi = logEntrySlots;   // invariant: all slots >= hi violate the predicate
+  while (lo < hi) {
+    const uint16_t mid = lo + (hi - lo) / 2;
+    const T_Timestamp ts = entryTimestamp(mid);
+    if (ts != 0L && ts >= first) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  #ifdef DEBUG_LOG
+    Serial.print(F("DEBUG_LOG: findLogHead() head: "));
+    Serial.println(lo);
+  #endif
+  return lo;
+}
+
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::writeCheckpoint() {
+  if (! checkpointed) return;
+  LogCheckpoint cp;
+  cp.headIndex = logHeadIndex;
+  cp.tailIndex = logTailIndex;
+  cp.lastNotifiedIndex = seqIndex(SEQ_BEFORE(lastNotifiedSeq, tailSeq()) ? tailSeq() - 1 : lastNotifiedSeq);
+  cp.crc = crc16((const uint8_t *) &cp, offsetof(LogCheckpoint, crc));
+  store->update(entryOffset(logEntrySlots), cp);
+}
+
+template <class T_LogTime>
+bool AbstractLogT<T_LogTime>::restoreCheckpoint() {
+  LogCheckpoint cp;
+  store->read(entryOffset(logEntrySlots), cp);
+  if (cp.crc != crc16((const uint8_t *) &cp, offsetof(LogCheckpoint, crc))) return false;
+  const uint16_t head = cp.headIndex;
+  const uint16_t tail = cp.tailIndex;
+  if (head >= logEntrySlots || tail >= logEntrySlots || cp.lastNotifiedIndex >= logEntrySlots || head == tail) return false;
+  
+  // a reset between writing a log entry and writing the checkpoint leaves the checkpoint behind the log:
+  const uint16_t afterHead = (head + 1) % logEntrySlots;
+  if (entryTimestamp(head) != 0L || entryTimestamp((logEntrySlots + head - 1) % logEntrySlots) == 0L) return false;
+  if (entryTimestamp(tail) == 0L) return false;
+  if (tail != afterHead && (tail != 0 || entryTimestamp(afterHead) != 0L)) return false;
+  
+  // the last notified entry lies between the one before the tail and the most recent one:
+  const uint16_t beforeTail = (logEntrySlots + tail - 1) % logEntrySlots;
+  const uint16_t notified = (logEntrySlots + cp.lastNotifiedIndex - beforeTail) % logEntrySlots;
+  const uint16_t entries = (logEntrySlots + head - tail) % logEntrySlots;
+  if (notified > entries) return false;
+  
+  logHeadIndex = head;
+  logTailIndex = tail;
+  lastNotifiedSeq = indexSeq(cp.lastNotifiedIndex);
+  return true;
+}
+
+template <class T_LogTime>
+uint32_t AbstractLogT<T_LogTime>::tailSeq() {
+  return headSeq - currentLogEntries();
+}
+
+template <class T_LogTime>
+uint16_t AbstractLogT<T_LogTime>::seqIndex(uint32_t seq) {
+  return (logHeadIndex + logEntrySlots - (uint16_t) (headSeq - seq)) % logEntrySlots;
+}
+
+template <class T_LogTime>
+uint32_t AbstractLogT<T_LogTime>::indexSeq(uint16_t index) {
+  const uint16_t distance = (logHeadIndex + logEntrySlots - index) % logEntrySlots;
+  return headSeq - (distance == 0 ? logEntrySlots : distance);
+}
+
+template <class T_LogTime>
+uint32_t AbstractLogT<T_LogTime>::findSeq(T_Timestamp ts) {
+  uint32_t lo = tailSeq();  // invariant: all entries < lo have an older timestamp
+  uint32_t hi = headSeq;    // invariant: all entries >= hi have a timestamp >= ts
+  // every non-empty slot except the head (which is not cleared while batching) holds a log entry:
+  for (uint16_t i = 0; i < indexSize; i++) {
+    const uint16_t slot = i * indexStride;
+    if (indexBuffer[i] == 0L || slot == logHeadIndex) continue;
+    const uint32_t seq = indexSeq(slot);
+    if (indexBuffer[i] < ts) {
+      if (! SEQ_BEFORE(seq, lo)) lo = seq + 1;
+    } else if (SEQ_BEFORE(seq, hi)) {
+      hi = seq;
+    }
+  }
+  while (SEQ_BEFORE(lo, hi)) {
+    const uint32_t mid = lo + (hi - lo) / 2;
+    if (entryTimestamp(seqIndex(mid)) < ts) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
   }
+  return lo;
+}
+
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::clearLogEntry(uint16_t index) {
+  T_LogEntry empty;
+  memset(&empty, 0x0, LOG_ENTRY_SIZE);
+  store->update(entryOffset(index), empty);
+  updateIndex(index, 0L);
 }
 
 
 /*
  * Generic log-entry creation.
  */
-LogEntry AbstractLog::addLogEntry(T_LogDataType_ID type, LogData *data) {
-  LogEntry entry;
+template <class T_LogTime>
+typename AbstractLogT<T_LogTime>::T_LogEntry AbstractLogT<T_LogTime>::addLogEntry(T_LogDataType_ID type, const LogData *data) {
+  T_LogEntry entry;
   entry.timestamp = logTime.timestamp();
   entry.type = type;
   memcpy(&(entry.data), data, sizeof(LogData));
   
   store->update(entryOffset(logHeadIndex), entry);
+  updateIndex(logHeadIndex, entry.timestamp);
   logHeadIndex = (logHeadIndex + 1) % logEntrySlots;
+  headSeq++;
   if (logHeadIndex == logTailIndex) {
     logTailIndex = (logTailIndex + 1) % logEntrySlots;
   }
-  // clear the next entry
-  clearLogEntry(logHeadIndex);
+  if (! batching) {
+    // clear the next entry
+    clearLogEntry(logHeadIndex);
+    writeCheckpoint();
+  }
   #ifdef DEBUG_LOG
 	Serial.print(F("DEBUG_LOG: addLogEntry() type: "));
 	Serial.print(entry.type);
 	Serial.print(F(" timestamp: "));
-	char buf[MAX_TIMESTAMP_STR_LEN];
-	Serial.print(formatTimestamp(entry.timestamp, buf));
+	char buf[MAX_PRECISE_TIMESTAMP_STR_LEN];
+	Serial.print(T_LogTime::format(entry.timestamp, buf));
 	Serial.print(F(" head: "));
 	Serial.print(logHeadIndex);
 	Serial.print(F(" tail: "));
@@ -169,66 +326,187 @@ LogEntry AbstractLog::addLogEntry(T_LogDataType_ID type, LogData *data) {
   return entry;
 }
 
-void AbstractLog::readMostRecentLogEntries(uint16_t maxResults) {
-  reader.kind = LogReaderKind::MOST_RECENT;
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::beginBatch() {
+  batching = true;
+}
+
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::commit() {
+  if (! batching) return;
+  batching = false;
+  clearLogEntry(logHeadIndex);
+  writeCheckpoint();
+}
+
+template <class T_LogTime>
+typename AbstractLogT<T_LogTime>::T_Timestamp AbstractLogT<T_LogTime>::appendBatch(const T_LogEntry *entries, uint16_t n) {
+  T_Timestamp ts = UNDEFINED_TIMESTAMP;
+  beginBatch();
+  for (uint16_t i = 0; i < n; i++) {
+    ts = addLogEntry(entries[i].type, &(entries[i].data)).timestamp;
+  }
+  commit();
+  return ts;
+}
+
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::readMostRecentLogEntries(LogCursor &cursor, uint16_t maxResults) {
+  cursor.kind = LogReaderKind::MOST_RECENT;
   uint16_t n = currentLogEntries();
   if (maxResults == 0) {
-      reader.toRead = n;
+      cursor.toRead = n;
   } else {
-    reader.toRead = maxResults < n ? maxResults : n;
+    cursor.toRead = maxResults < n ? maxResults : n;
   }
-  reader.read = 0;
-  reader.nextIndex = (logEntrySlots + logHeadIndex - 1) % logEntrySlots; // (logHeadIndex -1) can be negative => % function returns 0 ... !! => ensure always >= 0
+  cursor.read = 0;
+  cursor.nextSeq = headSeq - 1;
   #ifdef DEBUG_LOG
-    Serial.print(F("DEBUG_LOG: readMostRecentLogEntries() nextIndex: "));
-    Serial.println(reader.nextIndex);
+    Serial.print(F("DEBUG_LOG: readMostRecentLogEntries() nextSeq: "));
+    Serial.println(cursor.nextSeq);
   #endif
-  reader.valid = true;
+  cursor.valid = true;
 }
 
 
-void AbstractLog::readUnnotifiedLogEntries() {
-  reader.kind = LogReaderKind::UNNOTIFIED;
-  if (logHeadIndex > lastNotifiedLogEntryIndex) {
-    reader.toRead = logHeadIndex - lastNotifiedLogEntryIndex - 1;
-  } else {
-    reader.toRead = logEntrySlots - (lastNotifiedLogEntryIndex - logHeadIndex) - 1; // (logHeadIndex -1) can be negative => % function returns 0 ... !! => ensure always >= 0
-  }
-  reader.read = 0;
-  reader.nextIndex = (lastNotifiedLogEntryIndex + 1) % logEntrySlots;
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::readUnnotifiedLogEntries(LogCursor &cursor) {
+  cursor.kind = LogReaderKind::UNNOTIFIED;
+  // unnotified entries may have been overwritten:
+  cursor.nextSeq = SEQ_BEFORE(lastNotifiedSeq, tailSeq()) ? tailSeq() : lastNotifiedSeq + 1;
+  cursor.toRead = headSeq - cursor.nextSeq;
+  cursor.read = 0;
   #ifdef DEBUG_LOG
-    Serial.print(F("DEBUG_LOG: readUnnotifiedLogEntries() nextIndex: "));
-    Serial.println(reader.nextIndex);
+    Serial.print(F("DEBUG_LOG: readUnnotifiedLogEntries() nextSeq: "));
+    Serial.println(cursor.nextSeq);
   #endif
-  reader.valid = true;
+  cursor.valid = true;
+}
+
+
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::readRange(LogCursor &cursor, T_Timestamp from, T_Timestamp to, T_LogDataType_Mask typeMask) {
+  cursor.kind = LogReaderKind::RANGE;
+  cursor.nextSeq = findSeq(from);
+  cursor.endSeq = (to == (T_Timestamp) ~((T_Timestamp) 0)) ? headSeq : findSeq(to + 1);
+  if (SEQ_BEFORE(cursor.endSeq, cursor.nextSeq)) cursor.endSeq = cursor.nextSeq;  // to < from
+  cursor.typeMask = typeMask;
+  cursor.toRead = cursor.endSeq - cursor.nextSeq;
+  cursor.read = 0;
+  #ifdef DEBUG_LOG
+    Serial.print(F("DEBUG_LOG: readRange() nextSeq: "));
+    Serial.print(cursor.nextSeq);
+    Serial.print(F(", endSeq: "));
+    Serial.println(cursor.endSeq);
+  #endif
+  cursor.valid = true;
 }
 
  
-boolean AbstractLog::nextLogEntry(LogEntry &entry) {
-  if (reader.valid && reader.read < reader.toRead) {
-    store->read(entryOffset(reader.nextIndex), entry); 
-    #ifdef DEBUG_LOG
-      Serial.print(F("DEBUG_LOG: nextLogEntry() timestamp: "));
-      char buf[MAX_TIMESTAMP_STR_LEN];
-      Serial.print(formatTimestamp(entry.timestamp, buf));
-      Serial.print(F(", type: "));
-      Serial.println(entry.type);
-    #endif
-    reader.read++;
-    if (reader.kind == LogReaderKind::MOST_RECENT) {
-      reader.nextIndex = (logEntrySlots + reader.nextIndex - 1) % logEntrySlots; // (logHeadIndex -1) can be negative => % function returns 0 ... !! => ensure always >= 0
-      
-    } else if (reader.kind == LogReaderKind::UNNOTIFIED) {
-      lastNotifiedLogEntryIndex = reader.nextIndex;
-      reader.nextIndex = (reader.nextIndex + 1) % logEntrySlots;
+template <class T_LogTime>
+boolean AbstractLogT<T_LogTime>::nextLogEntry(LogCursor &cursor, T_LogEntry &entry) {
+  if (! cursor.valid) return false;
+  if (cursor.kind == LogReaderKind::MOST_RECENT) {
+    if (cursor.read >= cursor.toRead) return false;
+  } else if (cursor.kind == LogReaderKind::RANGE) {
+    // skip the entries of other types by reading their type only:
+    while (SEQ_BEFORE(cursor.nextSeq, cursor.endSeq) && ! SEQ_BEFORE(cursor.nextSeq, tailSeq()) && cursor.typeMask != LOG_TYPE_MASK_ALL) {
+      // stored types (also of garbage slots) can be >= 32 => evaluate LOG_TYPE_MASK() of a read value only once:
+      const T_LogDataType_ID type = store->read8(entryOffset(seqIndex(cursor.nextSeq)) + offsetof(T_LogEntry, type));
+      if (cursor.typeMask & LOG_TYPE_MASK(type)) break;
+      cursor.nextSeq++;
     }
-    #ifdef DEBUG_LOG
-      Serial.print(F("DEBUG_LOG: nextLogEntry() nextIndex: "));
-      Serial.println(reader.nextIndex);
-    #endif
-    return true;
+    if (! SEQ_BEFORE(cursor.nextSeq, cursor.endSeq)) return false;
+  } else if (! SEQ_BEFORE(cursor.nextSeq, headSeq)) {
+    return false;  // no new entry (yet)
+  }
+  if (SEQ_BEFORE(cursor.nextSeq, tailSeq()) || ! SEQ_BEFORE(cursor.nextSeq, headSeq)) {
+    cursor.valid = false;  // overwritten or cleared
+    return false;
+  }
+  store->read(entryOffset(seqIndex(cursor.nextSeq)), entry); 
+  #ifdef DEBUG_LOG
+    Serial.print(F("DEBUG_LOG: nextLogEntry() timestamp: "));
+    char buf[MAX_PRECISE_TIMESTAMP_STR_LEN];
+    Serial.print(T_LogTime::format(entry.timestamp, buf));
+    Serial.print(F(", type: "));
+    Serial.println(entry.type);
+  #endif
+  cursor.read++;
+  if (cursor.kind == LogReaderKind::MOST_RECENT) {
+    cursor.nextSeq--;
+    
+  } else if (cursor.kind == LogReaderKind::RANGE) {
+    cursor.nextSeq++;
+    
+  } else if (cursor.kind == LogReaderKind::UNNOTIFIED) {
+    if (SEQ_BEFORE(lastNotifiedSeq, cursor.nextSeq)) {
+      lastNotifiedSeq = cursor.nextSeq;
+      writeCheckpoint();
+    }
+    cursor.nextSeq++;
+  }
+  #ifdef DEBUG_LOG
+    Serial.print(F("DEBUG_LOG: nextLogEntry() nextSeq: "));
+    Serial.println(cursor.nextSeq);
+  #endif
+  return true;
+}
+
+template <class T_LogTime>
+uint16_t AbstractLogT<T_LogTime>::nextLogEntries(LogCursor &cursor, T_LogEntry *entries, uint16_t n) {
+  uint16_t count = 0;
+  if (cursor.kind == LogReaderKind::RANGE && cursor.typeMask != LOG_TYPE_MASK_ALL) {
+    while (count < n && nextLogEntry(cursor, entries[count])) count++;
+    return count;
   }
-  return false;
+  if (! cursor.valid) return 0;
+  if (cursor.kind == LogReaderKind::MOST_RECENT) {
+    if (cursor.toRead - cursor.read < n) n = cursor.toRead - cursor.read;
+    if (n == 0) return 0;
+    if (SEQ_BEFORE(cursor.nextSeq, tailSeq()) || ! SEQ_BEFORE(cursor.nextSeq, headSeq)) {
+      cursor.valid = false;  // overwritten or cleared
+      return 0;
+    }
+    // entries overwritten since the cursor was initialised are not returned:
+    if (cursor.nextSeq - tailSeq() + 1 < n) n = cursor.nextSeq - tailSeq() + 1;
+    while (count < n) {
+      // the entries are consecutive down to the first slot; read them as one block, then reverse them (newest first):
+      const uint16_t index = seqIndex(cursor.nextSeq);
+      const uint16_t run = n - count < index + 1 ? n - count : index + 1;
+      store->readBlock(entryOffset(index + 1 - run), (uint8_t *) (entries + count), run * LOG_ENTRY_SIZE);
+      for (uint16_t i = count, j = count + run - 1; i < j; i++, j--) {
+        const T_LogEntry e = entries[i];
+        entries[i] = entries[j];
+        entries[j] = e;
+      }
+      cursor.nextSeq -= run;
+      count += run;
+    }
+    cursor.read += count;
+    return count;
+  }
+  if (SEQ_BEFORE(cursor.nextSeq, tailSeq())) {
+    cursor.valid = false;  // overwritten or cleared
+    return 0;
+  }
+  const uint32_t endSeq = cursor.kind == LogReaderKind::RANGE ? cursor.endSeq : headSeq;
+  if (! SEQ_BEFORE(cursor.nextSeq, endSeq)) return 0;
+  if (endSeq - cursor.nextSeq < n) n = endSeq - cursor.nextSeq;
+  while (count < n) {
+    // the entries are consecutive up to the end of the slots:
+    const uint16_t index = seqIndex(cursor.nextSeq);
+    const uint16_t run = n - count < logEntrySlots - index ? n - count : logEntrySlots - index;
+    store->readBlock(entryOffset(index), (uint8_t *) (entries + count), run * LOG_ENTRY_SIZE);
+    cursor.nextSeq += run;
+    count += run;
+  }
+  cursor.read += count;
+  if (cursor.kind == LogReaderKind::UNNOTIFIED && SEQ_BEFORE(lastNotifiedSeq, cursor.nextSeq - 1)) {
+    lastNotifiedSeq = cursor.nextSeq - 1;
+    writeCheckpoint();
+  }
+  return count;
 }
 
 /*
@@ -250,12 +528,13 @@ void blink_S_O_S() {
   }
 }
 
-void AbstractLog::log_S_O_S(T_Message_ID id, int16_t param1, int16_t param2, uint16_t line) {
-  Timestamp ts = logMessage(id, param1, param2);
+template <class T_LogTime>
+void AbstractLogT<T_LogTime>::log_S_O_S(T_Message_ID id, int16_t param1, int16_t param2, uint16_t line) {
+  T_Timestamp ts = logMessage(id, param1, param2);
   ts = ts; // prevents warning: unused variable
-  char buf[MAX_TIMESTAMP_STR_LEN];
+  char buf[MAX_PRECISE_TIMESTAMP_STR_LEN];
   Serial.print(F("DEBUG_LOG: S.O.S. See log message "));
-  Serial.print(formatTimestamp(ts, buf));
+  Serial.print(T_LogTime::format(ts, buf));
   Serial.print(F(", message id "));
   Serial.print(uint16_t(id));
   Serial.print(F(", line "));
@@ -272,4 +551,6 @@ void write_S_O_S(const __FlashStringHelper *msg, uint16_t line) {
   blink_S_O_S();
 }
 
-
+// the two kinds of logs (see ACF_Logging.h):
+template class AbstractLogT<LogTime>;
+template class AbstractLogT<PreciseLogTime>;
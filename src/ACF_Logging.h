@@ -33,20 +33,33 @@
    * Discriminator for various types of log data.
    */
   typedef uint8_t T_LogDataType_ID;
+
+  /*
+   * Set of log data types (bit n = type n) for filtering log entries; only the types 0..31 can be filtered.
+   * Entries of types >= 32 only match LOG_TYPE_MASK_ALL (LOG_TYPE_MASK() of such a type is empty).
+   */
+  typedef uint32_t T_LogDataType_Mask;
+
+  #define LOG_TYPE_MASK(type) ((type) < 32 ? ((T_LogDataType_Mask) 1) << (type) : (T_LogDataType_Mask) 0)
+  #define LOG_TYPE_MASK_ALL   ((T_LogDataType_Mask) 0xFFFFFFFF)
   
   /**
    * Actual log record. At runtime the data field is an instance of a "subtype" of LogData.
    */
-  struct LogEntry {
-    Timestamp timestamp;
+  template <typename T_Timestamp> struct BasicLogEntry {
+    T_Timestamp timestamp;
     T_LogDataType_ID type;
     LogData   data; // generic
   };
 
+  typedef BasicLogEntry<Timestamp> LogEntry;
+  typedef BasicLogEntry<PreciseTimestamp> PreciseLogEntry;
+
     
   enum class LogReaderKind {
     MOST_RECENT = 0,  // reads newer to older
-    UNNOTIFIED = 1    // reads older to newer
+    UNNOTIFIED = 1,   // reads older to newer
+    RANGE = 2         // reads older to newer, AbstractLog only
   };
 
 
@@ -75,28 +88,88 @@
      */
     uint16_t nextIndex;
   };
+
+  /*
+   * Reader (=cursor) for the log entries of an AbstractLog; any number of cursors can iterate over the same log at the same time.
+   * A cursor addresses the log entries by sequence number rather than by slot: it remains valid while entries are added to the log
+   * until the entry it is about to return has been overwritten (i.e. the log has wrapped around beyond its position) or the log is cleared.
+   */
+  struct LogCursor {
+    /*
+     * Determines cursor behaviour.
+     */
+    LogReaderKind kind;
+    /*
+     * False if the cursor has not been initialised or if its position has been overwritten.
+     */
+    boolean valid = false;
+    /*
+     * MOST_RECENT: number of entries to be returned through this cursor (remains constant).
+     * UNNOTIFIED: number of unnotified entries when the cursor was initialised; the cursor also returns the entries added later.
+     * RANGE: number of entries in the time range (of any type) when the cursor was initialised.
+     */
+    uint16_t toRead;
+    /*
+     * Number of entries alreday returned by this cursor (increases with each entry read);
+     */
+    uint16_t read = 0;
+    /*
+     * Sequence number of the next entry that will be returned.
+     */
+    uint32_t nextSeq;
+    /*
+     * RANGE only: sequence number following the last entry in the time range, and the types of the entries to be returned.
+     */
+    uint32_t endSeq;
+    T_LogDataType_Mask typeMask;
+  };
   
 
+  /*
+   * Persisted copy of the in-memory log-managment structures (only if the log was created with checkpoint == true).
+   */
+  struct LogCheckpoint {
+    uint16_t headIndex;
+    uint16_t tailIndex;
+    uint16_t lastNotifiedIndex;
+    uint16_t crc;             // CRC-16 of the fields above
+  };
+
+
   /*
    * Logging is done to a ACF_Store::AbstractStore.
    * 
    * The log structure is as follows:
    * 
    * - logEntrySlots (=total number of log entry slots; used to detect changes => reset)
-   * - Actual log entries (LogEntry[logEntrySlots])
+   * - Actual log entries (T_LogEntry[logEntrySlots])
+   * - Optional checkpoint (LogCheckpoint)
+   *
+   * The timestamp generator T_LogTime determines the timestamp type and thus the log-entry layout: AbstractLog uses the 4-byte
+   * Timestamp of LogTime (at most 16 entries per second), AbstractPreciseLog the 8-byte millisecond PreciseTimestamp of
+   * PreciseLogTime (no limit on the entries per second).
    */
-  class AbstractLog {
+  template <class T_LogTime> class AbstractLogT {
     
     public:
       
+      typedef typename T_LogTime::TimestampType T_Timestamp;
+      typedef BasicLogEntry<T_Timestamp> T_LogEntry;
+      
       /*
        * @param store physical store to use for persistent storage; cannot be null.
+       * @param checkpoint true = persist head, tail and the last notified entry in a checkpoint after each change, so init() runs
+       *        in constant time and unnotified entries are not notified a second time after a board reset. The checkpoint is
+       *        ignored for stores on expiring media (EEPROM), whose checkpoint cells would wear out. It takes sizeof(LogCheckpoint)
+       *        bytes directly after the slots (which may reduce the number of slots); the checkpointed layout has its own magic number,
+       *        so (de)activating the checkpoint clears the log at the next init().
        */
-      AbstractLog(AbstractStore *store);
+      AbstractLogT(AbstractStore *store, bool checkpoint = false);
       
       /**
        * Initialise in-memory log-managment structures from the log entries found in the EEPROM.
        * This is typically performed after an Arduino board-reset.
+       * A valid checkpoint is used as is, else the log head is searched (see findLogHead()).
        * If the maximum number of log entries is found to be different from the previous run, then the
        * log is cleared and a message is logged to record the change in size.
        */
@@ -107,10 +180,19 @@
        */
       virtual void clear();
 
+      /*
+       * Provides RAM for a sparse index of the log: the index holds the timestamp of every k-th slot, where k is chosen so the
+       * index fits into the given number of timestamps (e.g. 32 timestamps = 128 bytes). readRange() then locates its position
+       * with log2(k) instead of log2(logEntrySlots) timestamp reads. The index is rebuilt by init() and clear() (size timestamp
+       * reads) and maintained as entries are added.
+       * Note: call before init() or clear(); the buffer must remain allocated as long as the log is used.
+       */
+      void setIndex(T_Timestamp *buffer, uint16_t size);
+
       /*
        * The timestamp generator for this log.
        */
-      LogTime logTime = LogTime();
+      T_LogTime logTime = T_LogTime();
       
       /*
        * Returns number of available slots for log entries.
@@ -129,31 +211,74 @@
        *       the message data structure to the consumers of this library. In its implementation, use addLogEntry() 
 	   *       to create of a new log entry.
        */
-      virtual Timestamp logMessage(T_Message_ID id, T_Message_Param param1, T_Message_Param param2) = 0;
+      virtual T_Timestamp logMessage(T_Message_ID id, T_Message_Param param1, T_Message_Param param2) = 0;
       
       /*
-       * Initialises the LogEntry reader to return at most maxResults of the most recent entries.
+       * Starts a batch of log entries: the entries added until commit() are written without clearing the slot ahead of each
+       * of them (and without updating the checkpoint); only the slot after the last one is cleared at commit(). This halves the
+       * write traffic (and wear) for bursts of entries, e.g. logging all sensors in one control cycle.
+       * Note: until commit() the head slot of the log is not cleared; if the board is reset before commit(), init() still
+       *       finds the entries written so far, provided the batch was shorter than the log.
+       */
+      void beginBatch();
+
+      /*
+       * Ends a batch of log entries by clearing the slot after the last entry (see beginBatch()).
+       */
+      void commit();
+
+      /*
+       * Adds n log entries as one batch (see beginBatch()). The timestamps of the given entries are ignored, every entry
+       * gets a new timestamp.
+       * @return the timestamp of the last entry
+       */
+      T_Timestamp appendBatch(const T_LogEntry *entries, uint16_t n);
+
+      /*
+       * Initialises the cursor to return at most maxResults of the most recent entries.
        * The entries are returned in decending order by timestamp (most recent first).
        * 
        * @param maxResults indicates how many log entries to return as a maximum; the special value 0 means to return all log entries
-       * Note: the reader is only valid as long the log is not being modified.
        */
-      void readMostRecentLogEntries(uint16_t maxResults);
+      void readMostRecentLogEntries(LogCursor &cursor, uint16_t maxResults);
 
       /*
-       * Initialises the LogEntry reader to return all the log entries that have not yet been notified to the client(s). 
-       * The entries are returned in ascending order by timestamp (oldest unnotified entry first).      
-       * Note: the reader is only valid as long the log is not being modified.
+       * Initialises the cursor to return all the log entries that have not yet been notified to the client(s), including the
+       * entries added while the cursor is in use. The entries are returned in ascending order by timestamp (oldest unnotified entry first).
+       * Every entry returned counts as notified (for all cursors).
        */
-      void readUnnotifiedLogEntries();
+      void readUnnotifiedLogEntries(LogCursor &cursor);
 
       /*
-       * Retuns the "next" entry of the log ("next" can be the next or the previous, depending on the reader kind). 
-       * Precondition: readMostRecentLogEntries() or readUnnotifiedLogEntries() was called and the log has not been modified since.
+       * Initialises the cursor to return the entries with from <= timestamp <= to whose type is in typeMask, e.g.
+       * LOG_TYPE_MASK(1) | LOG_TYPE_MASK(3) (types 0..31; entries of other types are returned for LOG_TYPE_MASK_ALL only). The entries are returned in ascending order by timestamp. The first entry is found by
+       * binary search over the timestamps, and the entries of other types are skipped by reading only their type.
+       * Note: the entries added after the cursor was initialised are not returned.
+       */
+      void readRange(LogCursor &cursor, T_Timestamp from, T_Timestamp to, T_LogDataType_Mask typeMask = LOG_TYPE_MASK_ALL);
+
+      /*
+       * Retuns the "next" entry of the log ("next" can be the next or the previous, depending on the cursor kind). 
+       * Precondition: readMostRecentLogEntries(), readUnnotifiedLogEntries() or readRange() was called for the cursor.
        * 
-       * @return true means the parameter 'entry' contains the next log entry, false means 'entry' has no defined semantics (i.e. after the last entry has been returned or if the log has been modified)
+       * @return true means the parameter 'entry' contains the next log entry, false means 'entry' has no defined semantics (i.e. after the
+       *         last entry has been returned, or if the entry at the position of the cursor has been overwritten => cursor.valid == false)
+       */
+      boolean nextLogEntry(LogCursor &cursor, T_LogEntry &entry);
+
+      /*
+       * Bulk version of nextLogEntry(): returns up to n entries in the entries array and the number of entries returned (0 after
+       * the last entry). Consecutive slots are read as one block from the store (MOST_RECENT cursors: then reversed in RAM), except
+       * for RANGE cursors filtering types.
+       */
+      uint16_t nextLogEntries(LogCursor &cursor, T_LogEntry *entries, uint16_t n);
+
+      /*
+       * Same as the functions above, using the log's own cursor (reader).
        */
-      boolean nextLogEntry(LogEntry &entry);
+      void readMostRecentLogEntries(uint16_t maxResults) { readMostRecentLogEntries(reader, maxResults); }
+      void readUnnotifiedLogEntries() { readUnnotifiedLogEntries(reader); }
+      boolean nextLogEntry(T_LogEntry &entry) { return nextLogEntry(reader, entry); }
 
       /*
        * Log a message, halt program execution and blink the universal S-O-S code on the Arduino board's LED.
@@ -174,6 +299,33 @@
        */
 	  uint16_t logEntrySlots;
 	  
+	  /*
+	   * True if head, tail and last notified entry are persisted in a LogCheckpoint after the log entries.
+	   */
+	  bool checkpointed;
+	  
+	  /*
+	   * True between beginBatch() and commit().
+	   */
+	  bool batching = false;
+	  
+	  /*
+	   * Optional sparse index (see setIndex()): indexBuffer[i] holds the timestamp of slot i * indexStride.
+	   */
+	  T_Timestamp *indexBuffer = NULL;
+	  uint16_t indexSize = 0;
+	  uint16_t indexStride = 0;
+	  
+	  /*
+	   * Reads the timestamps of the indexed slots from the store.
+	   */
+	  void rebuildIndex();
+	  
+	  /*
+	   * Updates the index if the slot at the given index is indexed.
+	   */
+	  void updateIndex(uint16_t slot, T_Timestamp ts);
+	  
 	  /*
 	   * Returns the "magic number" on the store used to identify whether the config area in the storage has been initialised.
 	   */
@@ -191,33 +343,87 @@
        */
       uint16_t logTailIndex = 0;
       /*
-       * Non-concurrent reader (=cursor) to iterate over log entries.
+       * The log's own cursor to iterate over log entries.
        */
-      LogReader reader;
+      LogCursor reader;
       
   #ifdef UNIT_TEST
     protected:
   #endif
       /*
-       * Index of last log entry that was notified to user.
+       * Sequence number of the entry to be written at logHeadIndex; counts the entries added to the log and jumps ahead by
+       * logEntrySlots at init() and clear(), which invalidates all existing cursors. Sequence numbers wrap around and are
+       * compared modulo 2^32, so cursors remain usable across the wrap-around (as long as they are within 2^31 of headSeq).
+       */
+      uint32_t headSeq = 0;
+
+      /*
+       * Sequence number of last log entry that was notified to user.
        */
-      uint16_t lastNotifiedLogEntryIndex = 0;
+      uint32_t lastNotifiedSeq = 0;
+
+      /*
+       * Returns the sequence number of the oldest log entry.
+       */
+      uint32_t tailSeq();
+
+      /*
+       * Returns the slot index of the log entry with the given sequence number; the entry must not be older than the slot before the tail.
+       */
+      uint16_t seqIndex(uint32_t seq);
+
+      /*
+       * Returns the sequence number of the log entry at the given slot index; the slot of the head is taken as the slot before the tail.
+       */
+      uint32_t indexSeq(uint16_t index);
+
+      /*
+       * Returns the sequence number of the oldest log entry with a timestamp >= ts (binary search, narrowed by the index if there is
+       * one), or headSeq if there is none.
+       */
+      uint32_t findSeq(T_Timestamp ts);
 
       /*
        * Calculates the byte-offset within the logging EEPROM space for the given entry index.
        */
       uint16_t entryOffset(uint16_t index);
 
+      /*
+       * Reads only the timestamp of the log entry at the given index.
+       */
+      T_Timestamp entryTimestamp(uint16_t index);
+
+      /*
+       * Returns the index of the log head (= the empty entry), found by binary search over the entry timestamps.
+       * Note: if the log contains no empty entry, the result is logEntrySlots.
+       */
+      uint16_t findLogHead();
+
+      /*
+       * Writes the current head, tail and last notified index to the checkpoint (if checkpointed).
+       */
+      void writeCheckpoint();
+
+      /*
+       * Restores head, tail and last notified index from the checkpoint if its CRC matches and if the timestamps of the
+       * entries at and next to the head and tail confirm the indexes.
+       * @return false if there is no valid checkpoint
+       */
+      bool restoreCheckpoint();
+
       /**
        * Clears the log entry at the current index but does not update logHead or logTail.
        */
       void clearLogEntry(uint16_t index);
       
       /**
-       * Creates and adds a log entry at the current logHead position, clears the next entry and updates logHead and logTail.
+       * Creates and adds a log entry at the current logHead position, clears the next entry (unless batching) and updates logHead and logTail.
        */ 
-      LogEntry addLogEntry(T_LogDataType_ID type, LogData *data);
+      T_LogEntry addLogEntry(T_LogDataType_ID type, const LogData *data);
   };
+
+  typedef AbstractLogT<LogTime> AbstractLog;
+  typedef AbstractLogT<PreciseLogTime> AbstractPreciseLog;
   
       
   /*
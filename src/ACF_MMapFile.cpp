@@ -0,0 +1,87 @@
+// Host (POSIX) builds only:
+#if !defined(ARDUINO)
+
+#include <ACF_MMapFile.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// #define DEBUG_MMAP
+
+MMapFileStore::MMapFileStore(const char *path, const uint32_t offset, const uint32_t size, const bool expiring) : AbstractStore(offset, size) {
+  this->path = path;
+  this->expiring = expiring;
+}
+
+MMapFileStore::~MMapFileStore() {
+  if (mapping != NULL) {
+    munmap(mapping, offsetBytes + sizeBytes);
+  }
+  if (fd >= 0) {
+    close(fd);
+  }
+}
+
+bool MMapFileStore::init() {
+  fd = open(path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) return false;
+  struct stat st;
+  const off_t length = offsetBytes + sizeBytes;
+  if (fstat(fd, &st) != 0 || (st.st_size < length && ftruncate(fd, length) != 0)) {
+    return initFailed();
+  }
+  void *m = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (m == MAP_FAILED) return initFailed();
+  mapping = (uint8_t *) m;
+  memory = mapping + offsetBytes;
+  #ifdef DEBUG_MMAP
+    Serial.print(F("DEBUG_MMAP init() "));
+    Serial.println(path);
+  #endif
+  return true;
+}
+
+bool MMapFileStore::initFailed() {
+  close(fd);
+  fd = -1;
+  return false;
+}
+
+void MMapFileStore::sync() {
+  msync(mapping, offsetBytes + sizeBytes, MS_SYNC);
+}
+
+void MMapFileStore::clear() {
+  memset(memory, 0x0, sizeBytes);
+}
+
+uint8_t MMapFileStore::read8(uint32_t idx) {
+  return memory[idx];
+}
+
+void MMapFileStore::write8(uint32_t idx, uint8_t val) {
+  memory[idx] = val;
+}
+
+bool MMapFileStore::update8(uint32_t idx, uint8_t val) {
+  if (memory[idx] == val) return false;
+  memory[idx] = val;
+  return true;
+}
+
+void MMapFileStore::readBlock(uint32_t idx, uint8_t *buf, uint32_t len) {
+  memcpy(buf, memory + idx, len);
+}
+
+void MMapFileStore::writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  memcpy(memory + idx, buf, len);
+}
+
+bool MMapFileStore::updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  if (memcmp(memory + idx, buf, len) == 0) return false;
+  memcpy(memory + idx, buf, len);
+  return true;
+}
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef ACF_MMAP_FILE_H_INCLUDED
+  #define ACF_MMAP_FILE_H_INCLUDED
+
+  #include <ACF_Store.h>
+
+  // Host (POSIX) builds only: Arduino boards have no file system to map.
+  #if !defined(ARDUINO)
+
+  /*
+   * A contiguous part of a memory-mapped file on a POSIX host. Use the file as a persistent stand-in for EEPROM or FRAM when running
+   * the library on a workstation, e.g. to replay long periods of log traffic or to keep state across test runs.<p>
+   *
+   * Note: This store must be initialised using init() after creation.
+   */
+  class MMapFileStore : public AbstractStore {
+    public:
+
+      /*
+       * @param path file name; the file is created if it does not exist and extended to offset + size bytes if it is shorter (new bytes are 0x0)
+       * @param offset number of bytes the first byte of this store is offset from the first byte of the file
+       * @param size number of bytes allocated to this store
+       * @param expiring return value of expiringMedia(); pass true to make clients behave as if the file were an EEPROM
+       */
+      MMapFileStore(const char *path, const uint32_t offset, const uint32_t size, const bool expiring = false);
+      ~MMapFileStore();
+
+      /*
+       * Opens and maps the file.
+       * @result return true if successful, else return false.
+       */
+      bool init();
+
+      /*
+       * Writes the mapped bytes to the file system (msync).
+       */
+      void sync();
+
+      bool expiringMedia() { return expiring; }
+      void clear();
+      uint8_t read8(uint32_t idx);
+      void write8(uint32_t idx, uint8_t val);
+      bool update8(uint32_t idx, uint8_t val);
+      void readBlock(uint32_t idx, uint8_t *buf, uint32_t len);
+      void writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+      bool updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+
+    protected:
+      const char *path;
+      bool expiring;
+      int fd = -1;
+      /*
+       * Start of the mapping (= first byte of the file).
+       */
+      uint8_t *mapping = NULL;
+      /*
+       * First byte of this store within the mapping.
+       */
+      uint8_t *memory = NULL;
+      
+      /*
+       * Closes the file after a failed init().
+       * @result return false.
+       */
+      bool initFailed();
+  };
+
+  #endif
+
+#endif
@@ -3,6 +3,34 @@
 
 // #define DEBUG_STATE
 
+#define NO_STATE_INDEX 0xFF
+
+/*
+ * Critical section of EventQueue::put(): disables interrupts and restores the previous state (interrupts stay disabled within an ISR).
+ * Note: on multi-core boards (ESP32 excepted), this only protects against producers on the same core.
+ */
+#if !defined(ARDUINO)
+  #define BEGIN_CRITICAL  // host build: no interrupts
+  #define END_CRITICAL
+#elif defined(__AVR__)
+  #define BEGIN_CRITICAL  const uint8_t interruptState = SREG; cli()
+  #define END_CRITICAL    SREG = interruptState
+#elif defined(__ARM_ARCH_PROFILE) && __ARM_ARCH_PROFILE == 'M'
+  // ARM Cortex-M (SAMD, STM32, nRF52, RP2040, Teensy, ...):
+  #define BEGIN_CRITICAL  uint32_t interruptState; \
+                          __asm__ volatile ("mrs %0, primask\n cpsid i" : "=r" (interruptState) :: "memory")
+  #define END_CRITICAL    __asm__ volatile ("msr primask, %0" :: "r" (interruptState) : "memory")
+#elif defined(ARDUINO_ARCH_ESP8266)
+  #define BEGIN_CRITICAL  const uint32_t interruptState = xt_rsil(15)
+  #define END_CRITICAL    xt_wsr_ps(interruptState)
+#elif defined(ARDUINO_ARCH_ESP32)
+  static portMUX_TYPE eventQueueMux = portMUX_INITIALIZER_UNLOCKED;  // spinlock across both cores
+  #define BEGIN_CRITICAL  portENTER_CRITICAL_SAFE(&eventQueueMux)
+  #define END_CRITICAL    portEXIT_CRITICAL_SAFE(&eventQueueMux)
+#else
+  #error "EventQueue::put(): no critical section for this architecture"
+#endif
+
 /*
  * ABSTRACT STATE
  */      
@@ -52,19 +80,9 @@ StateID AbstractSimpleState::trans(const Event event) {
   if (next == STATE_UNDEFINED && containingState != NULL) {
     next = containingState->trans(event);
   }
-  if (next != STATE_SAME && next != this->id() && next != STATE_UNDEFINED) {
-    exit(event, next);
-  }
   return next;
 }
 
-void AbstractSimpleState::exit(const Event event, const StateID next) {
-  exitAction();
-  if(containingState != NULL) { 
-    containingState->exit(event, next);
-  }
-}
-
 /*
  * COMPOSITE STATE
  */
@@ -75,6 +93,15 @@ void AbstractCompositeState::setSubstates(AbstractState **substates, uint8_t num
   // set containingStates of the subtates to "this":
   for(uint16_t i=0; i< this->numSubstates; i++) {
     this->substates[i]->containingState = this;
+    this->substates[i]->setDepth(depth + 1);
+  }
+}
+
+void AbstractCompositeState::setDepth(uint8_t depth) {
+  this->depth = depth;
+  // nested composite states may have been set up before "this" was added to its containing state:
+  for(uint16_t i=0; i< numSubstates; i++) {
+    substates[i]->setDepth(depth + 1);
   }
 }
       
@@ -89,21 +116,89 @@ StateID AbstractCompositeState::trans(const Event event) {
     next = containingState->trans(event);
   }
   return next;
-  // Do not invoke the exit action here: exits are performed "up" the containment hiearchy.
 }
 
-void AbstractCompositeState::exit(const Event event, const StateID next) {
-  // if the transition occurs within the substates of this containing state, then we will not exit this containing state
-  // and neither its containing states:
-  for(uint16_t i=0; i< numSubstates; i++) {
-    if (substates[i]->id() == next) {
-      return;
+
+/*
+ * TABLE STATE
+ */
+template <typename T_State> TableStateT<T_State>::TableStateT(const StateID id, const TransitionRow *table, uint16_t numRows, void *context) : stateID(id) {
+  this->context = context;
+  // find the rows of this state once, so transAction() only reads these:
+  for(uint16_t i=0; i<numRows; i++) {
+    if ((T_State_ID) pgm_read_byte(&table[i].state) == id.id()) {
+      if (rows == NULL) rows = table + i;
+      this->numRows++;
+    } else if (rows != NULL) {
+      break;
     }
   }
-  exitAction();
-  if(containingState != NULL) { 
-    containingState->exit(event, next);
+}
+
+template <typename T_State> StateID TableStateT<T_State>::transAction(const Event event) {
+  TransitionRow row;
+  for(uint8_t i=0; i<numRows; i++) {
+    memcpy_P(&row, rows + i, sizeof(TransitionRow));
+    if (row.event == event.id()) {
+      if (row.action != NULL) {
+        row.action(context);
+      }
+      return StateID(row.target);
+    }
   }
+  return STATE_UNDEFINED;
+}
+
+template class TableStateT<AbstractSimpleState>;
+template class TableStateT<AbstractCompositeState>;
+
+
+/*
+ * EVENT QUEUE
+ */
+EventQueue::EventQueue(T_Event_ID *buffer, uint8_t capacity) {
+  ASSERT(capacity >= 2, "capacity");
+  this->buffer = buffer;
+  this->capacity = capacity;
+}
+
+bool EventQueue::put(const Event event) {
+  // an ISR posting between reading and writing the head would otherwise overwrite the event of the loop (or vice versa):
+  BEGIN_CRITICAL;
+  const uint8_t next = (head + 1 == capacity) ? 0 : head + 1;
+  const bool queued = next != tail;
+  if (queued) {
+    buffer[head] = event.id();
+    head = next;  // publishes the event (single-byte write)
+  } else {
+    overflowCount++;
+  }
+  END_CRITICAL;
+  return queued;
+}
+
+bool EventQueue::get(T_Event_ID &event) {
+  if (tail == head) {
+    return false;
+  }
+  event = buffer[tail];
+  tail = (tail + 1 == capacity) ? 0 : tail + 1;
+  return true;
+}
+
+uint8_t EventQueue::size() {
+  const uint8_t h = head;
+  const uint8_t t = tail;
+  return h >= t ? h - t : capacity - t + h;
+}
+
+uint16_t EventQueue::overflows() {
+  // an ISR may update the (multi-byte) counter while it is being read:
+  uint16_t count;
+  do {
+    count = overflowCount;
+  } while (count != overflowCount);
+  return count;
 }
 
 
@@ -115,12 +210,19 @@ void AbstractStateAutomaton::setStates(AbstractState **states, uint8_t numStates
   this->states = states;
   ASSERT(numStates > 0, "numStates");
   this->numStates = numStates;
+  memset(stateIndex, NO_STATE_INDEX, sizeof(stateIndex));
+  for(uint8_t i=0; i<numStates; i++) {
+    const T_State_ID id = states[i]->id().id();
+    ASSERT(id >= 0, "state id range");
+    ASSERT(stateIndex[id] == NO_STATE_INDEX, "duplicate state id");
+    stateIndex[id] = i;
+  }
   if (initial == NULL) {
     currentState = states[0];
   } else {
     currentState = initial;
   }
-  currentStateStartMillis = millis();
+  currentStateStartMillis = clock->millis64();
 }
 
 EventSet AbstractStateAutomaton::acceptedUserEvents() {
@@ -168,12 +270,22 @@ void AbstractStateAutomaton::transition(const Event event) {
     }
     
   } else if (newStateID != STATE_SAME && oldStateID != newStateID) { // we are in a different new state!
-    currentState = state(newStateID);
+    AbstractState *next = state(newStateID);
+    AbstractState *container = commonContainer(currentState, next);
+    
+    // Exit up to the common container, then enter its substates down to the new state:
+    for (AbstractState *s = currentState; s != container; s = s->containingState) {
+      s->exitAction();
+      cancelTimeouts(s);
+    }
+    enterContainers(next, container);
+    currentState = next;
     
     // Enter the new state (which can be a composite state but will always end up in a simple state):
     newStateID = currentState->enter();
     currentState = state(newStateID);
-    currentStateStartMillis = millis();
+    currentStateStartMillis = clock->millis64();
+    armTimeouts(currentState, container);
     
     stateChanged(oldStateID, event, newStateID);
     
@@ -189,16 +301,140 @@ void AbstractStateAutomaton::transition(const Event event) {
   }
 }
 
-AbstractState *AbstractStateAutomaton::state(const StateID id) {
-  for(uint8_t i=0; i<numStates; i++) {
-    if (states[i]->id() == id) {
-      return states[i];
+bool AbstractStateAutomaton::post(const Event event) {
+  return queue != NULL && queue->put(event);
+}
+
+uint8_t AbstractStateAutomaton::dispatchPending(uint8_t maxEvents) {
+  if (queue == NULL || dispatching) {
+    return 0;
+  }
+  dispatching = true;
+  uint8_t count = 0;
+  T_Event_ID event;
+  while (count < maxEvents && queue->get(event)) {
+    transition(Event(event));
+    count++;
+  }
+  dispatching = false;
+  return count;
+}
+
+void AbstractStateAutomaton::setTimeouts(const StateTimeout *timeouts, uint8_t numTimeouts, StateDeadline *deadlines) {
+  this->timeouts = timeouts;
+  this->numTimeouts = numTimeouts;
+  this->deadlines = deadlines;
+  numDeadlines = 0;
+  armTimeouts(currentState, NULL);
+}
+
+uint8_t AbstractStateAutomaton::processTimeouts() {
+  const TimeMillis64 now = clock->millis64();
+  uint8_t count = 0;
+  while (numDeadlines > 0 && deadlines[0].due <= now) {
+    const T_Event_ID event = deadlines[0].event;
+    deadlines[0] = deadlines[--numDeadlines];
+    siftDownDeadline(0);
+    #ifdef DEBUG_STATE
+      Serial.print(F("DEBUG_STATE: timeout event 0x"));
+      Serial.println(event, HEX);
+    #endif
+    transition(Event(event));
+    count++;
+  }
+  return count;
+}
+
+TimeMillis AbstractStateAutomaton::millisUntilNextDeadline() {
+  if (numDeadlines == 0) {
+    return NO_DEADLINE;
+  }
+  const TimeMillis64 now = clock->millis64();
+  if (deadlines[0].due <= now) {
+    return 0;
+  }
+  const TimeMillis64 delta = deadlines[0].due - now;
+  return delta < NO_DEADLINE ? (TimeMillis) delta : NO_DEADLINE - 1;
+}
+
+void AbstractStateAutomaton::armTimeouts(AbstractState *state, AbstractState *container) {
+  const TimeMillis64 now = clock->millis64();
+  StateTimeout rule;
+  for (AbstractState *s = state; s != container; s = s->containingState) {
+    const T_State_ID id = s->id().id();
+    for (uint8_t i = 0; i < numTimeouts; i++) {
+      memcpy_P(&rule, timeouts + i, sizeof(StateTimeout));
+      if (rule.state != id) continue;
+      // sift up:
+      uint8_t k = numDeadlines++;
+      const StateDeadline deadline = {now + rule.timeout, rule.state, rule.event};
+      while (k > 0 && deadlines[(k - 1) / 2].due > deadline.due) {
+        deadlines[k] = deadlines[(k - 1) / 2];
+        k = (k - 1) / 2;
+      }
+      deadlines[k] = deadline;
     }
   }
+}
+
+void AbstractStateAutomaton::cancelTimeouts(AbstractState *state) {
+  const T_State_ID id = state->id().id();
+  uint8_t n = 0;
+  for (uint8_t i = 0; i < numDeadlines; i++) {
+    if (deadlines[i].state != id) deadlines[n++] = deadlines[i];
+  }
+  if (n == numDeadlines) {
+    return;
+  }
+  // restore the heap order:
+  numDeadlines = n;
+  for (uint8_t k = n / 2; k > 0; k--) {
+    siftDownDeadline(k - 1);
+  }
+}
+
+void AbstractStateAutomaton::siftDownDeadline(uint8_t index) {
+  const StateDeadline deadline = deadlines[index];
+  uint8_t k = index;
+  while (true) {
+    uint8_t child = 2 * k + 1;
+    if (child >= numDeadlines) break;
+    if (child + 1 < numDeadlines && deadlines[child + 1].due < deadlines[child].due) child++;
+    if (deadlines[child].due >= deadline.due) break;
+    deadlines[k] = deadlines[child];
+    k = child;
+  }
+  deadlines[k] = deadline;
+}
+
+AbstractState *AbstractStateAutomaton::state(const StateID id) {
+  if (id.id() >= 0 && stateIndex[id.id()] != NO_STATE_INDEX) {
+    return states[stateIndex[id.id()]];
+  }
   log->log_S_O_S(static_cast<uint8_t>(ACF_Msg::STATE_UNKNOWN_STATE), id.id(), 0, __LINE__);  // function NEVER RETURNS
   abort();
 }
 
+AbstractState *AbstractStateAutomaton::commonContainer(AbstractState *from, AbstractState *to) {
+  AbstractState *a = from;
+  AbstractState *b = to;
+  while (a->depth > b->depth) a = a->containingState;
+  while (b->depth > a->depth) b = b->containingState;
+  while (a != b) {
+    a = a->containingState;
+    b = b->containingState;
+  }
+  // a == NULL: no common container; a == to: "to" contains "from" => exit and re-enter "to":
+  return (a == to) ? to->containingState : a;
+}
+
+void AbstractStateAutomaton::enterContainers(AbstractState *state, AbstractState *container) {
+  if (state->containingState != container) {
+    enterContainers(state->containingState, container);
+    state->containingState->entryAction();
+  }
+}
+
 void AbstractStateAutomaton::stateChanged(const StateID, const Event, const StateID) {
   // do nothing
 }
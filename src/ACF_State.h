@@ -4,6 +4,7 @@
   #include <Arduino.h>
   #include <ACF_Types.h>
   #include <ACF_Logging.h>
+  #include <ACF_Clock.h>
 
   /* Base type for state serialisation. */
   typedef int8_t T_State_ID;
@@ -12,6 +13,9 @@
   typedef uint32_t T_Event_ID;
 
   static const char UNNAMED[] = "";
+  
+  /* Highest state ID (the full non-negative range of T_State_ID). */
+  #define MAX_STATE_ID 127
 
 
   /*
@@ -23,17 +27,14 @@
       /*
        * Constructor.
        *
-       * @param id unique identifier. Negative values are reserved by framework.
+       * @param id unique identifier. Negative values are reserved by framework; states of an automaton must not exceed MAX_STATE_ID.
        * @param name optional (pass NULL).
        */
-      StateID(const T_State_ID id, const char *name) {
-        this->value = id;
-        this->str = name;
-      }
+      constexpr StateID(const T_State_ID id, const char *name) : value(id), str(name) { }
       
-      StateID(const T_State_ID id) : StateID(id, NULL) {}
+      constexpr StateID(const T_State_ID id) : StateID(id, NULL) {}
       
-      T_State_ID id() const { return value; }
+      constexpr T_State_ID id() const { return value; }
       const char *name() const { return (str == NULL) ? UNNAMED : str; }
 	  
       bool operator ==(const StateID other) const { return value == other.value; }
@@ -64,14 +65,11 @@
 	   * @param id ids of events are powers of 2, i.e. 0, 1, 2, 3, 4
 	   * @param name optional (pass NULL)
 	   */
-	  Event(const T_Event_ID id, const char *name) {
-        this->value = id;
-        this->str = name;
-	  }
+	  constexpr Event(const T_Event_ID id, const char *name) : value(id), str(name) { }
 	  
-	  Event(const T_Event_ID id) : Event(id, NULL) {}
+	  constexpr Event(const T_Event_ID id) : Event(id, NULL) {}
 	  
-	  T_Event_ID id() const { return value; }
+	  constexpr T_Event_ID id() const { return value; }
 	  const char *name() const { return (str == NULL) ? UNNAMED : str; }
 	  
       bool operator ==(const Event other) const { return value == other.value; }
@@ -134,11 +132,16 @@
    * Note 2: All state classes are stateless in that they do not store any values during or after state changes or as a result of executing actions.
    */
   class AbstractState {
+    friend class AbstractStateAutomaton;
+    
     public:
     
       /* The containing state, or NULL if none.  */
       AbstractState *containingState = NULL;
       
+      /* Number of containing states (0 = top level). */
+      uint8_t depth = 0;
+      
       /*
        * Records whether an illegal transition has been logged at this state in order to avoid excessive logging.
        * Note: the presence of an event bit in the set EventCandidates means the attempt has been logged and will not be logged again
@@ -188,7 +191,7 @@
       /*
        * Handels the event and executes the transistion. If this state can't handle the event it delegates to the containing state's trans() method.
        * Handling the event consists of invoking its transAction() method (which may execute commands and computes the next state).
-       * Note: this method stays at the same state or transitions *out* of it but does *not yet enter* the next state.
+       * Note: this method neither exits this state nor enters the next state, see AbstractStateAutomaton::transition().
        * 
        * @return STATE_UNDEFINED if event wasn't handled, returns id() or STATE_SAME if current state does not change
        */
@@ -203,14 +206,12 @@
        * @return the actual new state, which is always a simple state; if "this" is a composite state, then the new state is its initial substate and so on.
        */
       virtual StateID enter() = 0;
-    
+      
       /*
-       * Performes the exit tasks of "this", then invokes the containing state's exit method.
-       * Note 1: exit methods are always invoked *up* the containment chain, i.e. simple state first, then its containing state(s).
-       * Note 2: You would normally override exitAction() rather than exit().
-       * Note 3: This method is typically invoked by the containing state itself or by the state automaton, not by the programmer.
+       * Sets the depth of this state (and of its substates, if any).
+       * Note: This method is invoked by AbstractCompositeState::setSubstates(), not by the programmer.
        */
-      virtual void exit(const Event event, const StateID next) = 0;
+      virtual void setDepth(uint8_t depth) { this->depth = depth; }
   
     protected:
           
@@ -224,7 +225,10 @@
       /* Executes the action(s) that are always performed when this state is entered. */
       virtual void entryAction();
       
-      /* Executes the action(s) that are always performed when this state is truly exited. */
+      /*
+       * Executes the action(s) that are always performed when this state is truly exited.
+       * Note: exit actions are invoked *up* the containment chain, i.e. simple state first, then its containing state(s).
+       */
       virtual void exitAction();
   };
 
@@ -238,11 +242,7 @@
       
       virtual StateID enter();
       
-      /* If the next state is different from "this" then the exit() method is invoked, which may directly trigger exit() at containing states. */
       virtual StateID trans(const Event event);
-
-    protected:
-      virtual void exit(const Event event, const StateID next);
   };
 
   
@@ -265,18 +265,131 @@
       /* Override. */
       virtual StateID enter();
       
-      /* Does not invoke the exit action (exits are triggered by simple states and are then performed "up" the containment hiearchy). */
       virtual StateID trans(const Event event);
       
+      /* Override: also sets the depth of the substates. */
+      virtual void setDepth(uint8_t depth);
+      
     protected:
     
-      AbstractState **substates;
-      uint16_t numSubstates;
+      AbstractState **substates = NULL;
+      uint16_t numSubstates = 0;
+  };
+
+  
+  /*
+   * Transition action of a TransitionRow; context is the one passed to the TableState.
+   */
+  typedef void (*T_TransitionAction)(void *context);
+  
+  /*
+   * Row of a transition table: in state, event leads to target (STATE_SAME.id(): no state change) executing the action (or NULL).
+   * The state and event IDs are constant expressions, so tables can be defined in PROGMEM:
+   *
+   *   static const TransitionRow TRANSITIONS[] PROGMEM = {
+   *     {STATE_A.id(), EVENT_A_B.id(), STATE_B.id(), &trans_A_B},
+   *     {STATE_B.id(), EVENT_B_A.id(), STATE_A.id(), NULL},
+   *   };
+   */
+  struct TransitionRow {
+    T_State_ID state;
+    T_Event_ID event;
+    T_State_ID target;
+    T_TransitionAction action;
+  };
+  
+  /*
+   * State whose transitions are defined by the rows of a transition table in PROGMEM rather than by overriding transAction().
+   * Events not found in the table are delegated to the containing state as usual.
+   * Use TableState for simple states and TableCompositeState for composite states; entry and exit actions can still be
+   * added by subclassing.
+   */
+  template <typename T_State> class TableStateT : public T_State {
+    public:
+      /*
+       * @param table transition table in PROGMEM, shared by all states of an automaton; the rows of a state must be adjacent
+       * @param numRows number of rows of the table
+       * @param context passed to the transition actions
+       */
+      TableStateT(const StateID id, const TransitionRow *table, uint16_t numRows, void *context = NULL);
+      
+      StateID id() { return stateID; }
+      
+    protected:
+      const StateID stateID;
+      void *context;
+      /* The rows of this state. */
+      const TransitionRow *rows = NULL;
+      uint8_t numRows = 0;
+      
+      /* Override: looks up the event in the rows of this state. */
+      StateID transAction(const Event event);
+  };
+  
+  typedef TableStateT<AbstractSimpleState> TableState;
+  typedef TableStateT<AbstractCompositeState> TableCompositeState;
+
+
+  
+  /*
+   * Fixed-capacity ring buffer of events for several producers (interrupt service routines and the loop, e.g. actions) and one
+   * consumer (the loop). put() disables interrupts while it updates the head (and restores the previous interrupt state, so it
+   * can be called from an ISR as well); get() needs no locking since only the consumer writes the tail.
+   */
+  class EventQueue {
+    public:
+      /*
+       * @param buffer array of size capacity; must remain allocated as long as this object is used
+       * @param capacity 2..255; the queue holds up to capacity - 1 events
+       */
+      EventQueue(T_Event_ID *buffer, uint8_t capacity);
       
-      /* If the next state is a simple state not contained by "this" then the exitAction() method is invoked (else we won't leave "this"). */      
-      virtual void exit(const Event event, const StateID next);
-         
+      /* Producer (ISR or loop): appends the event; returns false if the queue is full (the event is dropped and counted, see overflows()). */
+      bool put(const Event event);
+      
+      /* Consumer (the loop only): removes the oldest event; returns false if the queue is empty. */
+      bool get(T_Event_ID &event);
+      
+      /* Returns the number of queued events. */
+      uint8_t size();
+      
+      /* Returns the number of events dropped because the queue was full. */
+      uint16_t overflows();
+      
+    protected:
+      volatile T_Event_ID *buffer;
+      uint8_t capacity;
+      volatile uint8_t head = 0;  // next slot to write
+      volatile uint8_t tail = 0;  // next slot to read
+      volatile uint16_t overflowCount = 0;
+  };
+
+  
+  /*
+   * Timeout rule: once the automaton has been in state (or in a substate of it) for timeout [ms], it processes event.
+   * Like TransitionRows, tables of timeouts can be defined in PROGMEM:
+   *
+   *   static const StateTimeout TIMEOUTS[] PROGMEM = {
+   *     {STATE_C.id(), EVENT_C_C.id(), C_C_TIMEOUT},
+   *   };
+   */
+  struct StateTimeout {
+    T_State_ID state;
+    T_Event_ID event;
+    TimeMillis timeout;
+  };
+  
+  /*
+   * A pending timeout, see AbstractStateAutomaton::setTimeouts().
+   */
+  struct StateDeadline {
+    TimeMillis64 due;
+    T_State_ID state;
+    T_Event_ID event;
   };
+  
+  /* Returned by millisUntilNextDeadline() if there is no pending timeout. */
+  static const TimeMillis NO_DEADLINE = 0xFFFFFFFFul;
 
   
   /*
@@ -288,16 +401,19 @@
       /* Returns the current state. */
       AbstractState *state() { return currentState; }
     
-      /* Returns the timepoint ([ms] as returned by millis()) when the automaton transitioned to the current state. */
-      TimeMillis stateStartMillis() { return currentStateStartMillis; }
+      /* Returns the timepoint ([ms] as returned by millis() of the clock) when the automaton transitioned to the current state. */
+      TimeMillis stateStartMillis() { return (TimeMillis) currentStateStartMillis; }
     
     
       /* Returns the time [ms] spent so far at the current state. */
-      TimeMillis inStateMillis() { return millis() - currentStateStartMillis; }
+      TimeMillis inStateMillis() { return (TimeMillis) (clock->millis64() - currentStateStartMillis); }
+
+      /* Optional invocation: replaces the clock (by default the systemClock()), e.g. by a FakeClock for tests. Call before setStates(). */
+      void setClock(Clock *clock) { this->clock = clock; }
 
       /*
-       * Adds the states to the automaton.
-       * @param states an array of size numStates
+       * Adds the states to the automaton and builds the lookup table of their IDs.
+       * @param states an array of size numStates; the IDs must be unique and in the range 0..MAX_STATE_ID
        * @param numStates must be > 0
        * @param initial defines the initial state of the automaton. If NULL is passed, then the first element of passed states becomes the initial state.
        */
@@ -315,20 +431,90 @@
     
       /*
        * Execute trans(event) on the current state and enters the new state, if there is a transition to a new state at all.
-       * Note: executes all entry, exit and transition actions as defined and appropriate.
+       * Note: executes all entry, exit and transition actions as defined and appropriate: the states are exited up to the
+       * innermost state containing both the current and the new state, then entered down to the new state. A transition to
+       * a containing state exits and re-enters that state.
        */
       virtual void transition(const Event event);
+      
+      /* Optional invocation: attaches the queue used by post() and dispatchPending(). */
+      void setEventQueue(EventQueue *queue) { this->queue = queue; }
+      
+      /*
+       * Queues the event for dispatchPending() rather than processing it now; use in interrupt service routines and in actions
+       * (both may post to the same queue, see EventQueue::put()).
+       * @return false if there is no queue or it is full (see EventQueue::overflows())
+       */
+      bool post(const Event event);
+      
+      /*
+       * Processes up to maxEvents queued events in order, each by transition() and run to completion (including all its
+       * actions) before the next one is taken from the queue. Events posted meanwhile are processed in the same call, within the limit.
+       * Does nothing if invoked from an action during dispatchPending().
+       * @return the number of processed events
+       */
+      uint8_t dispatchPending(uint8_t maxEvents = 255);
+      
+      /*
+       * Optional invocation: sets timeout rules that the automaton evaluates itself, instead of eval() comparing the time in state.
+       * Entering a state arms the deadlines of its rules (from the clock, see setClock()), exiting it cancels them. A timeout
+       * fires once per entry of its state.
+       * Invoke after setStates() and setSubstates(): the deadlines of the current state (and its containing states) are armed immediately.
+       * @param timeouts table in PROGMEM
+       * @param numTimeouts number of rows of the table (max. 255)
+       * @param deadlines array of size numTimeouts; must remain allocated as long as this object is used
+       */
+      void setTimeouts(const StateTimeout *timeouts, uint8_t numTimeouts, StateDeadline *deadlines);
+      
+      /*
+       * Processes the events of all due timeouts (by transition()), earliest first.
+       * @return the number of processed events
+       */
+      uint8_t processTimeouts();
+      
+      /*
+       * Returns the time [ms] until the next timeout is due (0 if overdue), or NO_DEADLINE; lets the loop sleep or do other work meanwhile.
+       */
+      TimeMillis millisUntilNextDeadline();
     
     protected:
       AbstractState **states;
       uint8_t numStates;
       AbstractState *currentState;
       /* Timepoint [ms] of most recent transition to current state.  */
-      TimeMillis currentStateStartMillis = 0L;
+      TimeMillis64 currentStateStartMillis = 0L;
+      Clock *clock = systemClock();
       AbstractLog *log = NULL;
+      EventQueue *queue = NULL;
+      /* True while dispatchPending() processes events. */
+      bool dispatching = false;
+      /* Timeout rules (PROGMEM) and pending deadlines, a min-heap ordered by due time. */
+      const StateTimeout *timeouts = NULL;
+      uint8_t numTimeouts = 0;
+      StateDeadline *deadlines = NULL;
+      uint8_t numDeadlines = 0;
+      /* Index into states by state ID (128 bytes); NO_STATE_INDEX if there is no such state. */
+      uint8_t stateIndex[MAX_STATE_ID + 1];
 
       /* Maps ids to real states. */
       virtual AbstractState *state(const StateID id);
+      
+      /*
+       * Returns the innermost state containing both states (NULL if there is none); if to contains from, then the state containing to.
+       */
+      AbstractState *commonContainer(AbstractState *from, AbstractState *to);
+      
+      /* Invokes the entry actions from the state below container down to (excluding) state. */
+      void enterContainers(AbstractState *state, AbstractState *container);
+      
+      /* Arms the deadlines of the timeout rules of the state and of its containing states up to (excluding) container. */
+      void armTimeouts(AbstractState *state, AbstractState *container);
+      
+      /* Cancels the pending deadlines of the state. */
+      void cancelTimeouts(AbstractState *state);
+      
+      /* Moves the deadline at index down the heap to its place. */
+      void siftDownDeadline(uint8_t index);
 
       /* Override: use for logging, time-tracking, notifications, etc. */
       virtual void stateChanged(const StateID fromState, const Event event, const StateID toState);
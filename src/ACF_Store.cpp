@@ -2,7 +2,27 @@
 #include <ACF_Store.h>
   
 //#define DEBUG_STORE
-  
+
+/*
+ * ABSTRACT STORE: generic block access, byte by byte
+ */
+void AbstractStore::readBlock(uint32_t idx, uint8_t *buf, uint32_t len) {
+  for (uint32_t i=0; i<len; i++) *buf++ = read8(idx+i);
+}
+
+void AbstractStore::writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  for (uint32_t i=0; i<len; i++) write8(idx+i, *buf++);
+}
+
+bool AbstractStore::updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  bool updated = false;
+  for (uint32_t i=0; i<len; i++) updated |= update8(idx+i, *buf++);
+  return updated;
+}
+
+/*
+ * RAM STORE
+ */
 void RAMStore::clear() {
   const uint32_t len = offsetBytes + sizeBytes;
   #ifdef DEBUG_STORE
@@ -48,3 +68,37 @@ bool RAMStore::update8(uint32_t idx, uint8_t val) {
   return true;
 }
 
+void RAMStore::readBlock(uint32_t idx, uint8_t *buf, uint32_t len) {
+  memcpy(buf, memory + idx, len);
+  #if defined DEBUG_STORE
+    Serial.print(F("DEBUG_STORE readB ["));
+    Serial.print(idx);
+    Serial.print(F(".."));
+    Serial.print(idx + len - 1);
+    Serial.println(']');
+  #endif
+}
+
+void RAMStore::writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  memcpy(memory + idx, buf, len);
+  #ifdef DEBUG_STORE
+    Serial.print(F("DEBUG_STORE writeB["));
+    Serial.print(idx);
+    Serial.print(F(".."));
+    Serial.print(idx + len - 1);
+    Serial.println(']');
+  #endif
+}
+
+bool RAMStore::updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  if (memcmp(memory + idx, buf, len) == 0) return false;
+  memcpy(memory + idx, buf, len);
+  #ifdef DEBUG_STORE
+    Serial.print(F("DEBUG_STORE updB  ["));
+    Serial.print(idx);
+    Serial.print(F(".."));
+    Serial.print(idx + len - 1);
+    Serial.println(']');
+  #endif
+  return true;
+}
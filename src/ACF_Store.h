@@ -49,12 +49,19 @@
        * @return obj as passed as second parameter
        */
       template<typename T> T &read(uint32_t idx, T &obj){
-        uint8_t *ptr = (uint8_t*) &obj;
-        const uint32_t len = sizeof(T);
-        for (uint32_t i=0; i<len; i++) *ptr++ = read8(idx+i);
+        readBlock(idx, (uint8_t*) &obj, sizeof(T));
         return obj;
       }
     
+      /*
+       * Read a contiguous block of bytes from this store. The default implementation invokes read8() for each byte, 
+       * subclasses should override this function with a native implementation for their storage media.
+       * @param idx relative byte offset from the first byte of this store (i.e. not from the first byte of the underlying storage media)
+       * @param buf buffer of at least len bytes to receive the values read from the underlying storage media
+       * @param len number of bytes to read
+       */
+      virtual void readBlock(uint32_t idx, uint8_t *buf, uint32_t len);
+    
       /*
        * Write one byte to this store (unconditionally).
        * @param idx relative byte offset from the first byte of this store (i.e. not from the first byte of the underlying storage media)
@@ -69,11 +76,18 @@
 	   * @return obj as passed as second parameter
 	   */
 	  template<typename T> void write(uint32_t idx, const T &obj){
-		  const uint8_t *ptr = (const uint8_t*) &obj;
-		  const uint32_t len = sizeof(T);
-		  for (uint32_t i=0; i<len; i++)  write8(idx+i, *ptr++);
+		  writeBlock(idx, (const uint8_t*) &obj, sizeof(T));
 	  }
 	  
+	  /*
+	   * Write a contiguous block of bytes to this store (unconditionally). The default implementation invokes write8() for each byte, 
+	   * subclasses should override this function with a native implementation for their storage media.
+	   * @param idx relative byte offset from the first byte of this store (i.e. not from the first byte of the underlying storage media)
+	   * @param buf values to write to the underlying storage media
+	   * @param len number of bytes to write
+	   */
+	  virtual void writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+	  
       /*
        * Write one byte to this store if (and only if) the value currently stored at the given offset is different. This is important for
        * storage media whose storage cells have a limited lifespan, i.e. a limited number of writes like e.g. EEPROM. For non-expiring media update() is equivalent to write().
@@ -91,12 +105,18 @@
 	   * @result return true if obj is different from currently stored value, i.e. one or more bytes were changed, false otherwise
 	   */
       template<typename T> bool update(uint32_t idx, const T &obj){
-        const uint8_t *ptr = (const uint8_t*) &obj;
-        const uint32_t len = sizeof(T);
-		bool updated = false;
-        for (uint32_t i=0; i<len; i++)  updated |= update8(idx+i, *ptr++);
-        return updated;
+        return updateBlock(idx, (const uint8_t*) &obj, sizeof(T));
       }
+     
+      /*
+       * Write a contiguous block of bytes to this store. Only changed bytes are written. The default implementation invokes update8() for each byte, 
+       * subclasses should override this function with a native implementation for their storage media.
+       * @param idx relative byte offset from the first byte of this store (i.e. not from the first byte of the underlying storage media)
+       * @param buf values to write to the underlying storage media
+       * @param len number of bytes to write
+	   * @result return true if one or more bytes were changed, false otherwise
+       */
+      virtual bool updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
 
     protected:
       /*
@@ -122,6 +142,9 @@
       uint8_t read8(uint32_t idx);
       void write8(uint32_t idx, uint8_t val);
       bool update8(uint32_t idx, uint8_t val);
+      void readBlock(uint32_t idx, uint8_t *buf, uint32_t len);
+      void writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+      bool updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
 
    protected:
      uint8_t *memory;
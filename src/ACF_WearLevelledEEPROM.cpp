@@ -0,0 +1,225 @@
+// AMD M0 processors don't have an EEPROM:
+#if not defined(ARDUINO_SAMD_ZERO) && not defined(ARDUINO_SAMD_MKR1000)
+
+#include <ACF_WearLevelledEEPROM.h>
+
+// #define DEBUG_WEAR
+
+/*
+ * The magic number is the first byte of the physical region. It enables the detection of whether the region has been formatted before.
+ */
+const uint8_t MAGIC_NUMBER = 212;
+
+/*
+ * The step counter is kept in two copies, each followed by its bit-wise inverse. Even steps are written to copy 0, odd steps to copy 1,
+ * so a reset while a copy is being written leaves the other copy (the previous step) intact; init() uses the newest valid copy.
+ */
+struct StepsCopy {
+  uint32_t steps;
+  uint32_t inverse;
+};
+
+#define MAGIC_NUMBER_SIZE sizeof(uint8_t)
+#define STEPS_OFFSET      MAGIC_NUMBER_SIZE
+#define COUNTERS_OFFSET   (STEPS_OFFSET + 2 * sizeof(StepsCopy))
+#define COUNTER_SIZE      sizeof(uint32_t)
+
+static uint32_t pagesOffset(const uint16_t physicalPages, const bool persistCounters) {
+  return COUNTERS_OFFSET + (persistCounters ? physicalPages * COUNTER_SIZE : 0);
+}
+
+uint32_t WearLevelledEEPROMStore::physicalSize(const uint16_t physicalPages, const uint8_t pageSize, const bool persistCounters) {
+  return pagesOffset(physicalPages, persistCounters) + (uint32_t) physicalPages * pageSize;
+}
+
+WearLevelledEEPROMStore::WearLevelledEEPROMStore(const uint32_t offset, const uint32_t size, const uint16_t physicalPages, const uint8_t pageSize, const bool persistCounters)
+    : EEPROMStore(offset, physicalSize(physicalPages, pageSize, persistCounters)) {
+  sizeBytes = size;  // logical size
+  this->pageSize = pageSize;
+  this->logicalPages = (size + pageSize - 1) / pageSize;
+  this->physicalPages = physicalPages;
+  this->persistCounters = persistCounters;
+  this->rotationInterval = physicalPages;
+  counters = (uint32_t *) malloc(physicalPages * COUNTER_SIZE);
+  memset(counters, 0x0, physicalPages * COUNTER_SIZE);
+}
+
+WearLevelledEEPROMStore::~WearLevelledEEPROMStore() {
+  free(counters);
+}
+
+void WearLevelledEEPROMStore::init() {
+  if (EEPROMStore::read8(0) != MAGIC_NUMBER || ! readSteps()) {
+    #ifdef DEBUG_WEAR
+      Serial.println(F("DEBUG_WEAR init(): formatting"));
+    #endif
+    steps = 0;
+    memset(counters, 0x0, physicalPages * COUNTER_SIZE);
+    writeSteps(0);
+    writeSteps(1);
+    sync();
+    const uint32_t maxIndex = pageOffset(physicalPages);
+    for (uint32_t i = pageOffset(0); i < maxIndex; i++) {
+      EEPROMStore::update8(i, 0x0);
+    }
+    EEPROMStore::write8(0, MAGIC_NUMBER);
+  } else {
+    if (persistCounters) {
+      EEPROMStore::readBlock(COUNTERS_OFFSET, (uint8_t *) counters, physicalPages * COUNTER_SIZE);
+    }
+  }
+  writesSinceStep = 0;
+  #ifdef DEBUG_WEAR
+    Serial.print(F("DEBUG_WEAR init() steps: "));
+    Serial.println(steps);
+  #endif
+}
+
+bool WearLevelledEEPROMStore::readSteps() {
+  bool valid = false;
+  for (uint8_t copy = 0; copy < 2; copy++) {
+    StepsCopy c;
+    EEPROMStore::readBlock(STEPS_OFFSET + copy * sizeof(StepsCopy), (uint8_t *) &c, sizeof(c));
+    if (c.inverse == ~c.steps && (! valid || c.steps > steps)) {
+      steps = c.steps;
+      valid = true;
+    }
+  }
+  return valid;
+}
+
+void WearLevelledEEPROMStore::writeSteps(const uint8_t copy) {
+  StepsCopy c;
+  c.steps = steps;
+  c.inverse = ~steps;
+  EEPROMStore::updateBlock(STEPS_OFFSET + copy * sizeof(StepsCopy), (const uint8_t *) &c, sizeof(c));
+}
+
+void WearLevelledEEPROMStore::sync() {
+  if (persistCounters) {
+    EEPROMStore::updateBlock(COUNTERS_OFFSET, (const uint8_t *) counters, physicalPages * COUNTER_SIZE);
+  }
+}
+
+uint16_t WearLevelledEEPROMStore::physicalPage(const uint16_t logicalPage) {
+  // logical pages [logicalPages - moved .. logicalPages) have already been moved up by one in the current rotation:
+  const uint32_t rotation = steps / logicalPages;
+  const uint16_t moved = steps % logicalPages;
+  const uint32_t shift = rotation + (logicalPage >= logicalPages - moved ? 1 : 0);
+  return (logicalPage + shift) % physicalPages;
+}
+
+uint32_t WearLevelledEEPROMStore::pageOffset(const uint16_t physicalPage) {
+  return pagesOffset(physicalPages, persistCounters) + (uint32_t) physicalPage * pageSize;
+}
+
+uint32_t WearLevelledEEPROMStore::maxPageWrites() {
+  uint32_t max = 0;
+  for (uint16_t i = 0; i < physicalPages; i++) {
+    if (counters[i] > max) max = counters[i];
+  }
+  return max;
+}
+
+void WearLevelledEEPROMStore::written(const uint16_t physicalPage) {
+  counters[physicalPage]++;
+  if (++writesSinceStep >= rotationInterval) {
+    writesSinceStep = 0;
+    step();
+  }
+}
+
+void WearLevelledEEPROMStore::step() {
+  const uint16_t logicalPage = logicalPages - 1 - steps % logicalPages;
+  const uint16_t from = physicalPage(logicalPage);
+  const uint16_t to = (from + 1) % physicalPages;  // always unused
+  for (uint8_t i = 0; i < pageSize; i++) {
+    EEPROMStore::update8(pageOffset(to) + i, EEPROMStore::read8(pageOffset(from) + i));
+  }
+  counters[to]++;
+  // the page has been copied => commit the move:
+  steps++;
+  writeSteps(steps % 2);
+  sync();
+  #ifdef DEBUG_WEAR
+    Serial.print(F("DEBUG_WEAR step() page "));
+    Serial.print(logicalPage);
+    Serial.print(F(": "));
+    Serial.print(from);
+    Serial.print(F(" -> "));
+    Serial.println(to);
+  #endif
+}
+
+void WearLevelledEEPROMStore::clear() {
+  for (uint16_t p = 0; p < logicalPages; p++) {
+    const uint16_t page = physicalPage(p);
+    bool updated = false;
+    for (uint8_t i = 0; i < pageSize; i++) {
+      updated |= EEPROMStore::update8(pageOffset(page) + i, 0x0);
+    }
+    if (updated) {
+      written(page);
+    }
+  }
+}
+
+uint8_t WearLevelledEEPROMStore::read8(uint32_t idx) {
+  return EEPROMStore::read8(pageOffset(physicalPage(idx / pageSize)) + idx % pageSize);
+}
+
+void WearLevelledEEPROMStore::write8(uint32_t idx, uint8_t val) {
+  const uint16_t page = physicalPage(idx / pageSize);
+  EEPROMStore::write8(pageOffset(page) + idx % pageSize, val);
+  written(page);
+}
+
+bool WearLevelledEEPROMStore::update8(uint32_t idx, uint8_t val) {
+  const uint16_t page = physicalPage(idx / pageSize);
+  if (! EEPROMStore::update8(pageOffset(page) + idx % pageSize, val)) return false;
+  written(page);
+  return true;
+}
+
+void WearLevelledEEPROMStore::readBlock(uint32_t idx, uint8_t *buf, uint32_t len) {
+  while (len > 0) {
+    const uint8_t i = idx % pageSize;
+    const uint8_t n = len < (uint32_t) (pageSize - i) ? len : pageSize - i;
+    EEPROMStore::readBlock(pageOffset(physicalPage(idx / pageSize)) + i, buf, n);
+    buf += n;
+    idx += n;
+    len -= n;
+  }
+}
+
+void WearLevelledEEPROMStore::writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  while (len > 0) {
+    const uint8_t i = idx % pageSize;
+    const uint8_t n = len < (uint32_t) (pageSize - i) ? len : pageSize - i;
+    const uint16_t page = physicalPage(idx / pageSize);
+    EEPROMStore::writeBlock(pageOffset(page) + i, buf, n);
+    written(page);
+    buf += n;
+    idx += n;
+    len -= n;
+  }
+}
+
+bool WearLevelledEEPROMStore::updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+  bool updated = false;
+  while (len > 0) {
+    const uint8_t i = idx % pageSize;
+    const uint8_t n = len < (uint32_t) (pageSize - i) ? len : pageSize - i;
+    const uint16_t page = physicalPage(idx / pageSize);
+    if (EEPROMStore::updateBlock(pageOffset(page) + i, buf, n)) {
+      written(page);
+      updated = true;
+    }
+    buf += n;
+    idx += n;
+    len -= n;
+  }
+  return updated;
+}
+
+#endif
@@ -0,0 +1,135 @@
+#ifndef ACF_WEAR_LEVELLED_EEPROM_H_INCLUDED
+  #define ACF_WEAR_LEVELLED_EEPROM_H_INCLUDED
+
+  #include <ACF_EEPROM.h>
+
+  /*
+   * An EEPROMStore that spreads the wear of frequently written cells over a larger physical region.<p>
+   *
+   * The logical store is divided into pages which are mapped onto a larger number of physical pages. Every rotationInterval page writes
+   * one logical page is moved to the next higher physical page, so over time the placement of all logical pages rotates through the
+   * whole physical region and a "hot" cell (like the head of a log) wears all the physical pages evenly rather than one cell only.
+   * The rotation position is a single step counter stored in a small header; a page is copied before the step counter is increased, thus
+   * the store stays consistent if the board is reset during a step. The counter is written alternately to two copies guarded by their
+   * bit-wise inverse, so a reset while writing the counter falls back to the previous step rather than to a torn value.
+   *
+   * The store counts the page writes per physical page. The counters are kept in RAM and are optionally persisted on the EEPROM (at each
+   * rotation step and by sync()). maxPageWrites() reports the worst-case wear of any cell, i.e. the number of writes of the most worn page.
+   *
+   * Physical layout:
+   * - Magic number (1 byte)
+   * - Rotation steps, 2 copies (uint32_t steps + uint32_t inverted steps, each)
+   * - Page write counters (uint32_t[physicalPages]), only if counters are persisted
+   * - Pages (physicalPages * pageSize bytes)
+   *
+   * Note: This store must be initialised using init() after creation.
+   */
+  class WearLevelledEEPROMStore : public EEPROMStore {
+    public:
+
+      /*
+       * @param offset number of bytes the first byte of the physical region is offset from the first byte of the underlying EEPROM storage
+       * @param size number of (logical) bytes of this store
+       * @param physicalPages number of physical pages; must be larger than the number of logical pages (= size / pageSize, rounded up)
+       * @param pageSize number of bytes per page
+       * @param persistCounters store the page write counters on the EEPROM so the wear accounting survives resets
+       */
+      WearLevelledEEPROMStore(const uint32_t offset, const uint32_t size, const uint16_t physicalPages, const uint8_t pageSize = 16, const bool persistCounters = false);
+      ~WearLevelledEEPROMStore();
+
+      /*
+       * Number of bytes of the EEPROM occupied by this store, including header, counters and spare pages.
+       */
+      static uint32_t physicalSize(const uint16_t physicalPages, const uint8_t pageSize = 16, const bool persistCounters = false);
+
+      /*
+       * Reads the rotation state (and the page write counters, if persisted) from the EEPROM. Formats the physical region if it
+       * has not been initialised before.
+       */
+      void init();
+
+      /*
+       * Number of page writes after which one page is moved. Defaults to physicalPages, which limits the writes of the header
+       * to the average wear of the pages.
+       */
+      void setRotationInterval(const uint16_t writes) { rotationInterval = writes; }
+
+      /*
+       * Sets all the (logical) bytes of this store to 0x0.
+       */
+      void clear();
+
+      uint8_t read8(uint32_t idx);
+      void write8(uint32_t idx, uint8_t val);
+      bool update8(uint32_t idx, uint8_t val);
+      void readBlock(uint32_t idx, uint8_t *buf, uint32_t len);
+      void writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+      bool updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len);
+
+      /*
+       * Number of writes to the given physical page since the region was formatted (or since the board reset, if counters are not persisted).
+       */
+      uint32_t pageWrites(const uint16_t physicalPage) { return counters[physicalPage]; }
+
+      /*
+       * Worst-case wear of any cell of this store: the number of writes to the most written physical page.
+       */
+      uint32_t maxPageWrites();
+
+      /*
+       * Persists the page write counters (only if counters are persisted).
+       */
+      void sync();
+
+    protected:
+      uint8_t  pageSize;
+      uint16_t logicalPages;
+      uint16_t physicalPages;
+      bool     persistCounters;
+      uint16_t rotationInterval;
+      /*
+       * Number of single-page moves performed since the region was formatted.
+       */
+      uint32_t steps = 0;
+      /*
+       * Page writes since the last rotation step.
+       */
+      uint16_t writesSinceStep = 0;
+      /*
+       * Page write counters, indexed by physical page.
+       */
+      uint32_t *counters;
+
+      /*
+       * Physical page (index) currently holding the logical page.
+       */
+      uint16_t physicalPage(const uint16_t logicalPage);
+
+      /*
+       * Byte offset relative to offset() of the physical page.
+       */
+      uint32_t pageOffset(const uint16_t physicalPage);
+
+      /*
+       * Accounts for a write to the physical page; performs a rotation step if due.
+       */
+      void written(const uint16_t physicalPage);
+
+      /*
+       * Moves one logical page to the next higher physical page.
+       */
+      void step();
+
+      /*
+       * Reads the newest valid copy of the step counter.
+       * @result return false if neither copy is valid.
+       */
+      bool readSteps();
+
+      /*
+       * Writes the step counter to the given copy (0 or 1).
+       */
+      void writeSteps(const uint8_t copy);
+  };
+
+#endif
@@ -0,0 +1,80 @@
+#include <ArduinoUnit.h>
+
+#define UNIT_TEST
+#include <ACF_Clock.h>
+#include <ACF_LogTime.h>
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial) {
+    ; // wait for serial port to connect.
+  }
+  //Test::min_verbosity = TEST_VERBOSITY_ALL;
+  //Test::exclude("*");
+  //Test::include("b_*");
+}
+
+void loop() {
+  Test::run();
+}
+
+const TimeMillis64 DAY_MS = 24ull * 3600 * 1000;
+
+// ------ Unit Tests --------
+
+test(a_fake_clock) {
+  FakeClock clock = FakeClock(1000);
+  assertEqual(clock.millis64(), 1000ull);
+  clock.advance(90 * DAY_MS);
+  assertEqual(clock.millis64(), 1000ull + 90 * DAY_MS);
+  clock.set(5);
+  assertEqual(clock.millis64(), 5ull);
+}
+
+#if !defined(ARDUINO)
+  // the host delay() advances millis() without sleeping
+  test(b_arduino_clock_overflow) {
+    ArduinoClock clock = ArduinoClock();
+    TimeMillis64 t1 = clock.millis64();
+    delay(0xFFFFFFFF);  // millis() overflows
+    TimeMillis64 t2 = clock.millis64();
+    assertMoreOrEqual(t2, t1 + 0xFFFFFFFF);
+    assertLess(t2, t1 + 0xFFFFFFFF + 1000);
+  }
+#endif
+
+test(c_log_time_rollover) {
+  FakeClock clock = FakeClock(0xFFFFFFFFull - 1500);  // 1.5 seconds before millis() overflows
+  LogTime lt = LogTime();
+  lt.setClock(&clock);
+  Timestamp t1 = lt.timestamp();
+  assertEqual(t1 >> TIMESTAMP_ID_BITS, (0xFFFFFFFFul - 1500) / 1000);
+  clock.advance(3000);
+  Timestamp t2 = lt.timestamp();
+  assertEqual(t2 >> TIMESTAMP_ID_BITS, (t1 >> TIMESTAMP_ID_BITS) + 3);
+  
+  // months of timestamps within milliseconds:
+  for (uint16_t day = 0; day < 180; day++) {
+    clock.advance(DAY_MS);
+    Timestamp t3 = lt.timestamp();
+    assertMore(t3, t2);
+    t2 = t3;
+  }
+  assertEqual(t2 >> TIMESTAMP_ID_BITS, (uint32_t) (clock.millis64() / 1000));
+  
+  // a blocking LogTime doesn't wait for a FakeClock:
+  for (uint8_t i = 0; i < TIMESTAMP_IDS; i++) {
+    lt.timestamp();
+  }
+  assertEqual(lt.timestamp() >> TIMESTAMP_ID_BITS, (t2 >> TIMESTAMP_ID_BITS) + 1);
+}
+
+test(d_precise_log_time_rollover) {
+  FakeClock clock = FakeClock(0xFFFFFFFFull - 10);
+  PreciseLogTime lt = PreciseLogTime();
+  lt.setClock(&clock);
+  PreciseTimestamp t1 = lt.timestamp();
+  assertEqual(t1, 0xFFFFFFFFull - 10);
+  clock.advance(20);
+  assertEqual(lt.timestamp(), 0xFFFFFFFFull + 10);
+}
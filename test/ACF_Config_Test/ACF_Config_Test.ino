@@ -39,7 +39,7 @@ void loop() {
 
 class TestConfig_A : public AbstractConfigParams {
   public:
-    TestConfig_A(AbstractStore *store, const uint8_t version) : AbstractConfigParams(store, version)  { };
+    TestConfig_A(AbstractStore *store, const uint8_t version, bool atomic = false) : AbstractConfigParams(store, version, atomic)  { };
 
     // Actual configuration parameters (are public for test verification purposes)
     uint8_t param1[PARAM_1_LENGTH];
@@ -55,6 +55,10 @@ class TestConfig_A : public AbstractConfigParams {
         }
       }
     }
+    
+    void visitParams(ConfigParamVisitor &visitor) {
+      visitor.param(param1);
+    }
 
     void print() {
       AbstractConfigParams::print();
@@ -69,7 +73,7 @@ class TestConfig_A : public AbstractConfigParams {
 
 class TestConfig_B : public TestConfig_A {
   public:
-    TestConfig_B(AbstractStore *store, const uint8_t version) : TestConfig_A(store, version)  { };
+    TestConfig_B(AbstractStore *store, const uint8_t version, bool atomic = false) : TestConfig_A(store, version, atomic)  { };
 
     // Actual configuration parameters (are public for test verification purposes)
     int16_t param2;
@@ -84,6 +88,11 @@ class TestConfig_B : public TestConfig_A {
           updated = true;
       }
     }
+    
+    void visitParams(ConfigParamVisitor &visitor) {
+      TestConfig_A::visitParams(visitor);
+      visitor.param(param2);
+    }
 
     void print() {
       TestConfig_A::print();
@@ -96,6 +105,7 @@ test(params_a) {
   RAMStore store = RAMStore(CONFIG_SIZE_WITH_RESERVE);
   TestConfig_A config1 = TestConfig_A(&store, CONFIG_VERSION_A);
   assertEqual(config1.memSize(), sizeof(TestConfig_A));
+  assertEqual(config1.paramSize(), PARAM_1_LENGTH);
   
   config1.clear();
   assertEqual(config1.version(), 0);
@@ -140,6 +150,7 @@ test(params_b) {
   //
   TestConfig_B configB = TestConfig_B(&store, CONFIG_VERSION_B);
   assertEqual(configB.memSize(), sizeof(TestConfig_B));
+  assertEqual(configB.paramSize(), PARAM_1_LENGTH + sizeof(int16_t));  // packed
  
   configB.load();
   #ifdef DEBUG_UT_CONFIG
@@ -161,3 +172,161 @@ test(params_b) {
   assertEqual(configB2.version(), CONFIG_VERSION_B);
   assertEqual(configB2.param2, PARAM_2_NEW_VALUE);
 }
+
+/*
+ * Counts the store accesses.
+ */
+class CountingRAMStore : public RAMStore {
+  public:
+    CountingRAMStore(const uint32_t size) : RAMStore(size) { }
+    bool expiring = false;
+    uint32_t reads = 0;
+    uint32_t writes = 0;
+    uint32_t bytesWritten = 0;
+    uint32_t cellsWritten = 0;  // cells actually changed
+    bool expiringMedia() { return expiring; }
+    uint8_t read8(uint32_t idx) { reads++; return RAMStore::read8(idx); }
+    void readBlock(uint32_t idx, uint8_t *buf, uint32_t len) { reads++; RAMStore::readBlock(idx, buf, len); }
+    void writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len) { writes++; bytesWritten += len; cellsWritten += len; RAMStore::writeBlock(idx, buf, len); }
+    bool updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len) {
+      writes++;
+      bytesWritten += len;
+      for (uint32_t i = 0; i < len; i++) {
+        if (RAMStore::read8(idx + i) != buf[i]) cellsWritten++;
+      }
+      return RAMStore::updateBlock(idx, buf, len);
+    }
+};
+
+test(params_c_shadow) {
+  CountingRAMStore store = CountingRAMStore(CONFIG_SIZE_WITH_RESERVE);
+  TestConfig_B config = TestConfig_B(&store, CONFIG_VERSION_B);
+  uint8_t shadow[sizeof(TestConfig_B)];
+  assertLessOrEqual(config.paramSize(), sizeof(shadow));
+  config.setShadow(shadow);
+  config.load();
+  
+  // only the changed parameter is written, without reading the store:
+  store.reads = 0;
+  store.writes = 0;
+  store.bytesWritten = 0;
+  config.param2 = PARAM_2_NEW_VALUE;
+  config.save();
+  assertEqual(store.reads, 0u);
+  assertEqual(store.writes, 1u);
+  assertEqual(store.bytesWritten, 1u);  // 333 = 0x014D => 444 = 0x01BC
+  
+  // nothing changed => nothing written:
+  config.save();
+  assertEqual(store.writes, 1u);
+  
+  // nearby changes are written as one block:
+  store.writes = 0;
+  store.bytesWritten = 0;
+  config.param1[0] = PARAM_1_NEW_VALUE;
+  config.param1[2] = PARAM_1_NEW_VALUE;
+  config.save();
+  assertEqual(store.writes, 1u);
+  assertEqual(store.bytesWritten, 3u);
+  
+  TestConfig_B config2 = TestConfig_B(&store, CONFIG_VERSION_B);
+  config2.load();
+  assertEqual(config2.param1[0], PARAM_1_NEW_VALUE);
+  assertEqual(config2.param1[1], PARAM_1_DEFAULT_VALUE + 1);
+  assertEqual(config2.param1[2], PARAM_1_NEW_VALUE);
+  assertEqual(config2.param2, PARAM_2_NEW_VALUE);
+}
+
+#define ATOMIC_SLOT_SIZE  (sizeof(ConfigSlotHeader) + sizeof(TestConfig_B))  // with a reserve
+
+test(params_d_atomic) {
+  RAMStore store = RAMStore(2 * ATOMIC_SLOT_SIZE);
+  store.clear();
+  TestConfig_A configA = TestConfig_A(&store, CONFIG_VERSION_A, true);
+  configA.load();
+  assertEqual(configA.version(), CONFIG_VERSION_A);
+  uint16_t index = PARAM_1_LENGTH-1;
+  assertEqual(configA.param1[index], PARAM_1_DEFAULT_VALUE + index);
+  
+  // the new value goes to the other slot:
+  configA.param1[index] = PARAM_1_NEW_VALUE;
+  configA.save();
+  TestConfig_A configA2 = TestConfig_A(&store, CONFIG_VERSION_A, true);
+  configA2.load();
+  assertEqual(configA2.param1[index], PARAM_1_NEW_VALUE);
+  
+  // interrupted save(): the slot written last is corrupt => the values saved before are used
+  store.write8(ATOMIC_SLOT_SIZE + sizeof(ConfigSlotHeader) + index, PARAM_1_NEW_VALUE + 1);
+  TestConfig_A configA3 = TestConfig_A(&store, CONFIG_VERSION_A, true);
+  configA3.load();
+  assertEqual(configA3.version(), CONFIG_VERSION_A);
+  assertEqual(configA3.param1[index], PARAM_1_DEFAULT_VALUE + index);
+  
+  // extend by another parameter:
+  TestConfig_B configB = TestConfig_B(&store, CONFIG_VERSION_B, true);
+  configB.load();
+  assertEqual(configB.version(), CONFIG_VERSION_B);
+  assertEqual(configB.param1[index], PARAM_1_DEFAULT_VALUE + index);
+  assertEqual(configB.param2, PARAM_2_DEFAULT_VALUE);
+  configB.param2 = PARAM_2_NEW_VALUE;
+  configB.save();
+  
+  TestConfig_B configB2 = TestConfig_B(&store, CONFIG_VERSION_B, true);
+  configB2.load();
+  assertEqual(configB2.version(), CONFIG_VERSION_B);
+  assertEqual(configB2.param2, PARAM_2_NEW_VALUE);
+  
+  // both slots corrupt => defaults:
+  store.write8(sizeof(ConfigSlotHeader), 0xFF);
+  store.write8(ATOMIC_SLOT_SIZE + sizeof(ConfigSlotHeader), 0xFF);
+  TestConfig_B configB3 = TestConfig_B(&store, CONFIG_VERSION_B, true);
+  configB3.load();
+  assertEqual(configB3.param1[0], PARAM_1_DEFAULT_VALUE);
+  assertEqual(configB3.param2, PARAM_2_DEFAULT_VALUE);
+  
+  // expiring media: only the changed cells of the slot are written
+  CountingRAMStore eeprom = CountingRAMStore(2 * ATOMIC_SLOT_SIZE);
+  eeprom.clear();
+  eeprom.expiring = true;
+  TestConfig_B configB4 = TestConfig_B(&eeprom, CONFIG_VERSION_B, true);
+  configB4.load();       // slot 0
+  configB4.param2 = PARAM_2_NEW_VALUE;
+  configB4.save();       // slot 1
+  configB4.param2 = PARAM_2_DEFAULT_VALUE + 1;
+  eeprom.cellsWritten = 0;
+  configB4.save();       // slot 0 again: param2 and (part of) the header differ
+  assertLessOrEqual(eeprom.cellsWritten, sizeof(int16_t) + sizeof(ConfigSlotHeader));
+  assertLess(eeprom.cellsWritten, configB4.paramSize());
+}
+
+/*
+ * Doesn't implement visitParams() => legacy format.
+ */
+class TestConfig_Legacy : public AbstractConfigParams {
+  public:
+    TestConfig_Legacy(AbstractStore *store, const uint8_t version) : AbstractConfigParams(store, version)  { };
+
+    uint8_t param1[PARAM_1_LENGTH];
+    int16_t param2;
+
+    uint16_t memSize() { return sizeof(*this); };
+    
+    void initParams(boolean &updated) {
+      updated = param2 == 0;
+      if (updated) param2 = PARAM_2_DEFAULT_VALUE;
+    }
+};
+
+test(params_e_legacy) {
+  RAMStore store = RAMStore(CONFIG_SIZE_WITH_RESERVE + sizeof(TestConfig_Legacy));
+  TestConfig_Legacy config = TestConfig_Legacy(&store, CONFIG_VERSION_B);
+  assertMoreOrEqual(config.paramSize(), PARAM_1_LENGTH + sizeof(int16_t));  // includes padding (if any)
+  config.load();
+  assertEqual(config.param2, PARAM_2_DEFAULT_VALUE);
+  config.param2 = PARAM_2_NEW_VALUE;
+  config.save();
+  
+  TestConfig_Legacy config2 = TestConfig_Legacy(&store, CONFIG_VERSION_B);
+  config2.load();
+  assertEqual(config2.param2, PARAM_2_NEW_VALUE);
+}
@@ -0,0 +1,314 @@
+#include <ArduinoUnit.h>
+
+#define UNIT_TEST
+#include <ACF_Messages.h>
+#include <ACF_Store.h>
+#include <ACF_FrameLog.h>
+
+//#define DEBUG_UT_FRAME_LOG
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial) {
+    ; // wait for serial port to connect.
+  }
+  //Test::min_verbosity = TEST_VERBOSITY_ALL;
+}
+
+void loop() {
+  Test::run();
+}
+
+
+const uint16_t RING_SIZE = 100;
+const uint16_t STORE_SIZE = sizeof(uint8_t) + sizeof(uint16_t) + RING_SIZE;  // uint8_t = magic number, uint16_t = ring size
+
+enum class LogDataType : T_LogDataType_ID {
+  MESSAGE = 0,
+  VALUES = 1,
+  DUMP = 2
+};
+
+struct LogMessageData {
+  T_Message_ID id;
+  int16_t   params[2];
+};
+
+class TestFrameLog : public AbstractFrameLog {
+  public:
+    TestFrameLog(AbstractStore *store, uint8_t keyframeInterval = 0) : AbstractFrameLog(store, keyframeInterval) { };
+
+    Timestamp logMessage(T_Message_ID id, int16_t param1, int16_t param2) {
+      LogMessageData data;
+      data.id = id;
+      data.params[0] = param1;
+      data.params[1] = param2;
+      return addLogFrame(static_cast<T_LogDataType_ID>(LogDataType::MESSAGE), &data, sizeof(data));
+    }
+
+    // only the bytes actually needed are logged:
+    Timestamp logValue(int16_t value) {
+      return addLogFrame(static_cast<T_LogDataType_ID>(LogDataType::VALUES), &value, sizeof(value));
+    }
+
+    Timestamp logDump(const uint8_t *data, uint8_t len) {
+      return addLogFrame(static_cast<T_LogDataType_ID>(LogDataType::DUMP), data, len);
+    }
+};
+
+#define MESSAGE_FRAME_SIZE (LOG_FRAME_OVERHEAD + sizeof(LogMessageData))
+#define VALUE_FRAME_SIZE (LOG_FRAME_OVERHEAD + sizeof(int16_t))
+
+int16_t entryValue(LogEntry &e) {
+  int16_t value;
+  memcpy(&value, &(e.data), sizeof(value));
+  return value;
+}
+
+// ------ Unit Tests --------
+
+test(a_frame_log_ring_buffer) {
+  RAMStore store = RAMStore(STORE_SIZE);
+  TestFrameLog logging = TestFrameLog(&store);
+
+  logging.clear();
+  assertEqual(logging.ringSize(), RING_SIZE);
+  assertEqual(logging.currentLogEntries(), 1u);
+  assertEqual(logging.currentLogBytes(), MESSAGE_FRAME_SIZE);
+  assertEqual(logging.logTailIndex, 0u);
+  assertEqual(logging.logHeadIndex, MESSAGE_FRAME_SIZE);
+
+  int16_t v = 0;
+  // fill up to the end of the ring:
+  while (logging.logHeadIndex + VALUE_FRAME_SIZE + 1 <= RING_SIZE) {
+    logging.logValue(++v);
+  }
+  assertEqual(logging.logTailIndex, 0u);
+  const uint16_t fullEntries = logging.currentLogEntries();
+  assertEqual(fullEntries, 1u + v);
+
+  // wrap around: the oldest entries make room
+  for (uint16_t i = 0; i < 3 * fullEntries; i++) {
+    logging.logValue(++v);
+    assertTrue(logging.currentLogBytes() < RING_SIZE);
+    assertTrue(logging.currentLogEntries() >= fullEntries - 2u);
+    logging.readMostRecentLogEntries(1);
+    LogEntry e;
+    assertTrue(logging.nextLogEntry(e));
+    assertEqual(entryValue(e), v);
+    assertEqual(e.type, static_cast<T_LogDataType_ID>(LogDataType::VALUES));
+  }
+}
+
+test(b_frame_log_init) {
+  RAMStore store = RAMStore(STORE_SIZE);
+  TestFrameLog logging = TestFrameLog(&store);
+  logging.clear();
+  uint8_t dump[40];
+  for (uint8_t i = 0; i < sizeof(dump); i++) dump[i] = i;
+
+  // mix of frame sizes, init() after every entry must restore head, tail and entries:
+  for (int16_t v = 1; v <= 60; v++) {
+    if (v % 7 == 0) {
+      logging.logDump(dump, 10 + v % 30);
+    } else if (v % 3 == 0) {
+      logging.logMessage(v, v, -v);
+    } else {
+      logging.logValue(v);
+    }
+    TestFrameLog logging2 = TestFrameLog(&store);
+    logging2.init();
+    assertEqual(logging2.logHeadIndex, logging.logHeadIndex);
+    assertEqual(logging2.logTailIndex, logging.logTailIndex);
+    assertEqual(logging2.currentLogEntries(), logging.currentLogEntries());
+    assertEqual(logging2.currentLogBytes(), logging.currentLogBytes());
+  }
+}
+
+test(c_frame_log_init_clear) {
+  RAMStore store = RAMStore(STORE_SIZE);
+  TestFrameLog logging = TestFrameLog(&store);
+
+  logging.clear();
+  uint8_t magicNumber = store.read8(0);
+  logging.init();
+  logging.logValue(3000);
+  logging.logValue(3100);
+  assertEqual(logging.currentLogEntries(), 3u);
+
+  // delete magic number --> must clear and rewrite magic number
+  store.write8(0, 0);
+  logging.init();
+  assertEqual(magicNumber, store.read8(0));
+  assertEqual(logging.currentLogEntries(), 2u);
+}
+
+test(d_frame_log_reader_unnotified) {
+  RAMStore store = RAMStore(STORE_SIZE);
+  TestFrameLog logging = TestFrameLog(&store);
+  LogEntry e;
+
+  logging.clear();
+  logging.readUnnotifiedLogEntries();
+  assertEqual(logging.reader.toRead, 1u);
+  assertTrue(logging.nextLogEntry(e));
+  assertEqual(e.type, static_cast<T_LogDataType_ID>(LogDataType::MESSAGE));
+  assertFalse(logging.nextLogEntry(e));
+
+  logging.logValue(1);
+  logging.logValue(2);
+  logging.readUnnotifiedLogEntries();
+  assertTrue(logging.nextLogEntry(e));
+  assertEqual(entryValue(e), 1);
+  logging.logValue(3);  // invalidates the reader
+  assertFalse(logging.nextLogEntry(e));
+
+  logging.readUnnotifiedLogEntries();
+  assertEqual(logging.reader.toRead, 2u);
+  assertTrue(logging.nextLogEntry(e));
+  assertEqual(entryValue(e), 2);
+  assertTrue(logging.nextLogEntry(e));
+  assertEqual(entryValue(e), 3);
+  assertFalse(logging.nextLogEntry(e));
+
+  // unnotified entries that are overwritten are lost:
+  for (int16_t v = 4; v <= 40; v++) {
+    logging.logValue(v);
+  }
+  logging.readUnnotifiedLogEntries();
+  assertEqual(logging.reader.toRead, logging.currentLogEntries());
+  int16_t expected = 41 - logging.currentLogEntries();
+  while (logging.nextLogEntry(e)) {
+    assertEqual(entryValue(e), expected++);
+  }
+  assertEqual(expected, 41);
+}
+
+test(e_frame_log_reader_most_recent) {
+  RAMStore store = RAMStore(STORE_SIZE);
+  TestFrameLog logging = TestFrameLog(&store);
+  LogEntry e;
+
+  logging.clear();
+  for (int16_t v = 1; v <= 25; v++) {
+    logging.logValue(v);
+  }
+  logging.readMostRecentLogEntries(0);
+  assertEqual(logging.reader.toRead, logging.currentLogEntries());
+  int16_t expected = 25;
+  while (logging.nextLogEntry(e)) {
+    assertEqual(entryValue(e), expected--);
+  }
+  assertEqual(expected, 25 - (int16_t) logging.currentLogEntries());
+
+  logging.readMostRecentLogEntries(3);
+  assertEqual(logging.reader.toRead, 3u);
+}
+
+test(f_frame_log_large_frame) {
+  RAMStore store = RAMStore(STORE_SIZE);
+  TestFrameLog logging = TestFrameLog(&store);
+  logging.clear();
+  uint8_t dump[60];
+  for (uint8_t i = 0; i < sizeof(dump); i++) dump[i] = 100 + i;
+  for (int16_t v = 1; v <= 8; v++) {
+    logging.logValue(v);
+  }
+  logging.logDump(dump, sizeof(dump));
+  logging.logValue(9);
+
+  logging.readMostRecentLogEntries(2);
+  LogFrame frame;
+  uint8_t payload[sizeof(dump)];
+  assertTrue(logging.nextLogFrame(frame, payload, sizeof(payload)));
+  assertEqual(frame.length, sizeof(int16_t));
+  assertTrue(logging.nextLogFrame(frame, payload, sizeof(payload)));
+  assertEqual(frame.type, static_cast<T_LogDataType_ID>(LogDataType::DUMP));
+  assertEqual(frame.length, sizeof(dump));
+  assertEqual(memcmp(payload, dump, sizeof(dump)), 0);
+
+  // nextLogEntry() truncates to LogData:
+  LogEntry e;
+  logging.readMostRecentLogEntries(2);
+  assertTrue(logging.nextLogEntry(e));
+  assertTrue(logging.nextLogEntry(e));
+  assertEqual(memcmp(e.data.payload, dump, sizeof(LogData)), 0);
+}
+
+test(g_frame_log_capacity) {
+  // short entries take less space than the slots of AbstractLog:
+  const uint16_t SIZE = sizeof(uint8_t) + sizeof(uint16_t) + 40 * sizeof(LogEntry);
+  RAMStore store = RAMStore(SIZE);
+  TestFrameLog logging = TestFrameLog(&store);
+  logging.clear();
+  for (int16_t v = 1; v <= 200; v++) {
+    logging.logValue(v);
+  }
+  #ifdef DEBUG_UT_FRAME_LOG
+    Serial.print(F("DEBUG_UT_FRAME_LOG: entries: "));
+    Serial.println(logging.currentLogEntries());
+  #endif
+  assertTrue(logging.currentLogEntries() > 40u * sizeof(LogEntry) / VALUE_FRAME_SIZE - 2);
+  assertTrue(logging.currentLogEntries() > 40u);
+}
+
+test(h_compact_timestamps) {
+  // compact format: readers and init() must restore the exact timestamps, also after the keyframes of the oldest frames were removed
+  RAMStore store = RAMStore(STORE_SIZE);
+  TestFrameLog logging = TestFrameLog(&store, 4);
+  logging.clear();
+  const int16_t VALUES = 150;
+  Timestamp ts[VALUES + 1];
+  LogEntry e;
+  for (int16_t v = 1; v <= VALUES; v++) {
+    delay((v % 5) * 700L + (v % 11 == 0 ? 200000L : 0));  // mix of small and large deltas
+    ts[v] = logging.logValue(v);
+
+    TestFrameLog logging2 = TestFrameLog(&store, 4);
+    logging2.init();
+    assertEqual(logging2.logHeadIndex, logging.logHeadIndex);
+    assertEqual(logging2.logTailIndex, logging.logTailIndex);
+    assertEqual(logging2.currentLogEntries(), logging.currentLogEntries());
+    logging2.readMostRecentLogEntries(0);
+    int16_t expected = v;
+    while (logging2.nextLogEntry(e)) {
+      if (expected > 0) {
+        assertEqual(entryValue(e), expected);
+        assertEqual(e.timestamp, ts[expected]);
+      }
+      expected--;
+    }
+    // the next timestamp continues after the most recent one:
+    assertTrue(logging2.logTime.timestamp() > ts[v]);
+
+    if (v % 3 == 0) {
+      logging.readUnnotifiedLogEntries();
+      Timestamp previous = 0L;
+      while (logging.nextLogEntry(e)) {
+        assertTrue(e.timestamp > previous);
+        if (e.type == static_cast<T_LogDataType_ID>(LogDataType::VALUES)) {
+          assertEqual(e.timestamp, ts[entryValue(e)]);
+        }
+        previous = e.timestamp;
+      }
+      assertEqual(previous, ts[v]);
+    }
+  }
+}
+
+test(i_compact_capacity) {
+  // short entries with compact timestamps: nearly twice as many entries as the 39 entries of an AbstractLog of the same size
+  const uint16_t SIZE = sizeof(uint8_t) + sizeof(uint16_t) + 40 * sizeof(LogEntry);
+  RAMStore store = RAMStore(SIZE);
+  TestFrameLog logging = TestFrameLog(&store, 16);
+  logging.clear();
+  for (int16_t v = 1; v <= 200; v++) {
+    delay(1000);
+    logging.logValue(v);
+  }
+  #ifdef DEBUG_UT_FRAME_LOG
+    Serial.print(F("DEBUG_UT_FRAME_LOG: compact entries: "));
+    Serial.println(logging.currentLogEntries());
+  #endif
+  assertTrue(logging.currentLogEntries() > 70u);
+}
@@ -0,0 +1,168 @@
+#include <ArduinoUnit.h>
+
+#define UNIT_TEST
+#include <ACF_Messages.h>
+#include <ACF_Store.h>
+#include <ACF_Logging.h>
+#include <ACF_LogExport.h>
+
+void setup() {
+  Serial.begin(9600);
+  while (!Serial) {
+    ; // wait for serial port to connect.
+  }
+  //Test::min_verbosity = TEST_VERBOSITY_ALL;
+  //Test::exclude("*");
+  //Test::include("b_*");
+}
+
+void loop() {
+  Test::run();
+}
+
+
+const uint16_t UNIT_TEST_LOG_ENTRIES = 20;  // numer of LogEntry slots
+const uint16_t STORE_SIZE = sizeof(uint8_t) + sizeof(uint16_t) + UNIT_TEST_LOG_ENTRIES * sizeof(LogEntry);
+
+struct LogMessageData {
+  T_Message_ID id;
+  int16_t   params[2];
+};
+
+struct LogValuesData {
+  int16_t value;
+  byte    filler[3];
+};
+
+class TestLog : public AbstractLog {
+  public:
+    TestLog(AbstractStore *store) : AbstractLog(store) { }; 
+  
+    Timestamp logMessage(T_Message_ID id, int16_t param1, int16_t param2) {
+      LogMessageData data;
+      memset(&data, 0x0, sizeof(data));
+      data.id = id;
+      data.params[0] = param1;
+      data.params[1] = param2;
+      return addLogEntry(0, (LogData *) &data).timestamp;
+    }
+
+    Timestamp logValues(int16_t value) {
+      LogValuesData data;
+      memset(&data, 0x0, sizeof(data));
+      data.value = value;
+      return addLogEntry(1, (LogData *) &data).timestamp;
+    }
+};
+
+/*
+ * Collects the bytes written and counts the calls of write().
+ */
+class BufferPrint : public Print {
+  public:
+    uint8_t buf[512];
+    uint16_t len = 0;
+    uint16_t writes = 0;
+    size_t write(uint8_t c) { writes++; buf[len++] = c; return 1; }
+    size_t write(const uint8_t *b, size_t size) { writes++; memcpy(buf + len, b, size); len += size; return size; }
+};
+
+// ------ Unit Tests --------
+
+test(a_export_binary) {
+  RAMStore store = RAMStore(STORE_SIZE); 
+  TestLog logging = TestLog(&store);
+  logging.clear();
+  for (int16_t v = 1; v <= 30; v++) {
+    logging.logValues(v);  // wraps around
+  }
+  
+  BufferPrint out;
+  LogCursor cursor;
+  logging.readUnnotifiedLogEntries(cursor);
+  assertEqual(exportLog(logging, cursor, out), 19u);
+  
+  // header + 3 frames (8 + 8 + 3 entries) + end
+  assertEqual(out.len, 4 + 3 + 19 * sizeof(LogEntry) + 1);
+  assertEqual(out.buf[0], LOG_EXPORT_MAGIC_NUMBER);
+  assertEqual(out.buf[1], LOG_EXPORT_VERSION);
+  assertEqual(out.buf[2], sizeof(Timestamp));
+  assertEqual(out.buf[3], sizeof(LogEntry));
+  assertEqual(out.writes, 1u + 3 * 2 + 1);
+  
+  // decode:
+  uint16_t pos = 4;
+  int16_t v = 12;
+  Timestamp last = 0;
+  while (out.buf[pos] != 0) {
+    uint8_t n = out.buf[pos++];
+    for (uint8_t i = 0; i < n; i++) {
+      LogEntry e;
+      memcpy(&e, out.buf + pos, sizeof(LogEntry));
+      pos += sizeof(LogEntry);
+      assertMore(e.timestamp, last);
+      last = e.timestamp;
+      LogValuesData lvd;
+      memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+      assertEqual(lvd.value, v++);
+    }
+  }
+  assertEqual(v, 31);
+  assertEqual(pos, out.len - 1);
+  
+  // all entries have been notified:
+  logging.readUnnotifiedLogEntries(cursor);
+  assertEqual(cursor.toRead, 0u);
+}
+
+test(b_export_most_recent) {
+  RAMStore store = RAMStore(STORE_SIZE); 
+  TestLog logging = TestLog(&store);
+  logging.clear();
+  for (int16_t v = 1; v <= 5; v++) {
+    logging.logValues(v);
+  }
+  BufferPrint out;
+  LogCursor cursor;
+  logging.readMostRecentLogEntries(cursor, 3);
+  assertEqual(exportLog(logging, cursor, out), 3u);
+  LogEntry e;
+  memcpy(&e, out.buf + 5, sizeof(LogEntry));
+  LogValuesData lvd;
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 5);
+}
+
+test(c_export_most_recent_wrapped) {
+  RAMStore store = RAMStore(STORE_SIZE); 
+  TestLog logging = TestLog(&store);
+  logging.clear();
+  for (int16_t v = 1; v <= 30; v++) {
+    logging.logValues(v);  // wraps around
+  }
+  
+  // newest first, blocks of consecutive slots across the wrap-around:
+  LogCursor cursor;
+  logging.readMostRecentLogEntries(cursor, 0);
+  LogEntry entries[8];
+  LogValuesData lvd;
+  int16_t v = 30;
+  uint16_t n;
+  while ((n = logging.nextLogEntries(cursor, entries, 8)) > 0) {
+    for (uint16_t i = 0; i < n; i++) {
+      memcpy(&lvd, &(entries[i].data), sizeof(LogValuesData));
+      assertEqual(lvd.value, v--);
+    }
+  }
+  assertEqual(v, 11);
+  assertEqual(cursor.read, 19u);
+  assertTrue(cursor.valid);
+  
+  BufferPrint out;
+  logging.readMostRecentLogEntries(cursor, 0);
+  assertEqual(exportLog(logging, cursor, out), 19u);
+  LogEntry e;
+  memcpy(&e, out.buf + 5 + 7 * sizeof(LogEntry), sizeof(LogEntry));  // last entry of the first frame
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 23);
+}
@@ -36,7 +36,7 @@ test(log_timestamp) {
   LogTime lt = LogTime();
   Timestamp t1 = lt.timestamp();
   assertEqual(t1>>TIMESTAMP_ID_BITS, sec); // check same second
-  assertEqual(t1 & 0xF, 0L); // check identity counter
+  assertEqual(t1 & TIMESTAMP_ID_MASK, 0L); // check identity counter
 
   // 1 .. 15
   Timestamp t2;
@@ -44,7 +44,7 @@ test(log_timestamp) {
     t2 = lt.timestamp();
     assertMore(t2, t1);
     assertEqual(t2>>TIMESTAMP_ID_BITS, sec);
-    assertEqual(t2 & 0xF, i);
+    assertEqual(t2 & TIMESTAMP_ID_MASK, i);
     t1 = t2;
   }
   // 16
@@ -59,3 +59,66 @@ test(log_timestamp) {
   assertEqual(t1 & 0xF, 1L);
 }
 
+
+test(log_timestamp_nonblocking) {
+  delay(1000);
+  uint32_t ms = millis();
+  if (ms % 1000 > 500) {
+    delay(1000 - (ms % 1000) + 1);
+    ms = millis();
+  }
+  uint32_t sec = ms / 1000;
+  LogTime lt = LogTime(false);
+  Timestamp t1 = lt.timestamp();
+  assertEqual(t1>>TIMESTAMP_ID_BITS, sec);
+  
+  // 40 timestamps borrow the identifiers of the next 2 seconds without delay():
+  Timestamp t2;
+  for(uint32_t i=1; i<40; i++) {
+    t2 = lt.timestamp();
+    assertMore(t2, t1);
+    assertEqual(t2>>TIMESTAMP_ID_BITS, sec + i / TIMESTAMP_IDS);
+    assertEqual(t2 & TIMESTAMP_ID_MASK, i % TIMESTAMP_IDS);
+    t1 = t2;
+  }
+  assertLess(millis() - ms, 500ul);
+  
+  // the clock has not yet reached the borrowed seconds:
+  delay(1000);
+  t2 = lt.timestamp();
+  assertEqual(t2>>TIMESTAMP_ID_BITS, sec + 2);
+  assertEqual(t2 & TIMESTAMP_ID_MASK, 40ul % TIMESTAMP_IDS);
+  
+  // ... and catches up:
+  delay(2000);
+  t2 = lt.timestamp();
+  assertEqual(t2>>TIMESTAMP_ID_BITS, sec + 3);
+  assertEqual(t2 & TIMESTAMP_ID_MASK, 0ul);
+}
+
+test(log_timestamp_format) {
+  char buf[MAX_TIMESTAMP_STR_LEN];
+  assertEqual(strcmp(formatTimestamp((123456789ul << TIMESTAMP_ID_BITS) | 15, buf), "123456789.15"), 0);
+  assertEqual(strcmp(formatTimestamp(3ul << TIMESTAMP_ID_BITS, buf), "000000003.00"), 0);
+}
+
+test(log_precise_timestamp) {
+  PreciseLogTime lt = PreciseLogTime();
+  PreciseTimestamp t1 = lt.timestamp();
+  // 1000 unique timestamps without delay():
+  const uint32_t ms = millis();
+  for(uint16_t i=0; i<1000; i++) {
+    PreciseTimestamp t2 = lt.timestamp();
+    assertMore(t2, t1);
+    t1 = t2;
+  }
+  assertLess(millis() - ms, 500ul);
+  
+  // continues after the most recent timestamp of the previous run:
+  PreciseLogTime lt2 = PreciseLogTime();
+  lt2.adjust(t1 + 5000);
+  assertMore(lt2.timestamp(), t1 + 5000);
+  
+  char buf[MAX_PRECISE_TIMESTAMP_STR_LEN];
+  assertEqual(strcmp(formatPreciseTimestamp(1234567890123ull, buf), "1234567890.123"), 0);
+}
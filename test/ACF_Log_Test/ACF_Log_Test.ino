@@ -4,6 +4,10 @@
 #include <ACF_Messages.h>
 #include <ACF_Store.h>
 #include <ACF_Logging.h>
+#if !defined(ARDUINO)
+  #include <ACF_MMapFile.h>
+  #include <unistd.h>
+#endif
 
 //#define DEBUG_UT_LOGGING
 
@@ -48,7 +52,7 @@ static_assert(sizeof(LogValuesData) <= sizeof(LogData), "LogValuesData > LogData
 
 class TestLog : public AbstractLog {
   public:
-    TestLog(AbstractStore *store) : AbstractLog(store) { }; 
+    TestLog(AbstractStore *store, bool checkpoint = false) : AbstractLog(store, checkpoint) { }; 
   
     Timestamp logMessage(T_Message_ID id, int16_t param1, int16_t param2) {
       LogMessageData data;
@@ -67,6 +71,56 @@ class TestLog : public AbstractLog {
       LogEntry e = addLogEntry(static_cast<T_LogDataType_ID>(LogDataType::VALUES), (LogData *) &data);
       return e.timestamp;
     }
+
+    /* Moves the sequence numbers, e.g. close to their wrap-around. */
+    uint32_t head() { return headSeq; }
+    
+    void shiftSeq(uint32_t delta) {
+      headSeq += delta;
+      lastNotifiedSeq += delta;
+    }
+
+    Timestamp logType(T_LogDataType_ID type) {
+      LogData data;
+      memset(&data, 0x0, sizeof(data));
+      LogEntry e = addLogEntry(type, &data);
+      return e.timestamp;
+    }
+};
+
+class TestPreciseLog : public AbstractPreciseLog {
+  public:
+    TestPreciseLog(AbstractStore *store) : AbstractPreciseLog(store) { }; 
+  
+    PreciseTimestamp logMessage(T_Message_ID id, int16_t param1, int16_t param2) {
+      LogMessageData data;
+      memset(&data, 0x0, sizeof(data));
+      data.id = id;
+      data.params[0] = param1;
+      data.params[1] = param2;
+      return addLogEntry(static_cast<T_LogDataType_ID>(LogDataType::MESSAGE), (LogData *) &data).timestamp;
+    }
+
+    PreciseTimestamp logValues(int16_t value) {
+      LogValuesData data;
+      memset(&data, 0x0, sizeof(data));
+      data.value = value;
+      return addLogEntry(static_cast<T_LogDataType_ID>(LogDataType::VALUES), (LogData *) &data).timestamp;
+    }
+};
+
+/*
+ * Counts the bytes passed to block updates and writes, and the number of reads.
+ */
+class CountingRAMStore : public RAMStore {
+  public:
+    CountingRAMStore(const uint32_t size) : RAMStore(size) { }
+    uint32_t bytesWritten = 0;
+    uint32_t reads = 0;
+    uint8_t read8(uint32_t idx) { reads++; return RAMStore::read8(idx); }
+    void readBlock(uint32_t idx, uint8_t *buf, uint32_t len) { reads++; RAMStore::readBlock(idx, buf, len); }
+    void writeBlock(uint32_t idx, const uint8_t *buf, uint32_t len) { bytesWritten += len; RAMStore::writeBlock(idx, buf, len); }
+    bool updateBlock(uint32_t idx, const uint8_t *buf, uint32_t len) { bytesWritten += len; return RAMStore::updateBlock(idx, buf, len); }
 };
 
 // ------ Unit Tests --------
@@ -287,6 +341,448 @@ test(e_log_reader_most_recent) {
   assertFalse(logging.nextLogEntry(e));
 }
 
+test(f_log_replay_file) {
+  #if defined(ARDUINO)
+    Serial.println(F("Memory-mapped files are only supported by host builds -> skip"));
+  #else
+    // replay a long period of log traffic against a file-backed log, then "reset the board":
+    const char *PATH = "ACF_Log_Test.mmap";
+    const uint16_t SLOTS = 200;
+    const uint32_t ENTRIES = 50000L;
+    unlink(PATH);
+    MMapFileStore store = MMapFileStore(PATH, 0, sizeof(uint8_t) + sizeof(uint16_t) + SLOTS * sizeof(LogEntry));
+    assertTrue(store.init());
+    TestLog logging = TestLog(&store);
+    logging.init();
+    for (uint32_t i = 0; i < ENTRIES; i++) {
+      logging.logValues(i % 30000);
+    }
+    assertEqual(logging.currentLogEntries(), SLOTS - 1u);
+    const uint16_t head = logging.logHeadIndex;
+    const uint16_t tail = logging.logTailIndex;
+    store.sync();
+    
+    MMapFileStore store2 = MMapFileStore(PATH, 0, store.size());
+    assertTrue(store2.init());
+    TestLog logging2 = TestLog(&store2);
+    logging2.init();
+    assertEqual(logging2.logHeadIndex, head);
+    assertEqual(logging2.logTailIndex, tail);
+    logging2.readMostRecentLogEntries(1);
+    LogEntry e;
+    assertTrue(logging2.nextLogEntry(e));
+    LogValuesData lvd;
+    memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+    assertEqual(lvd.value, (int16_t) ((ENTRIES - 1) % 30000));
+    unlink(PATH);
+  #endif
+}
+
+test(g_log_init_search) {
+  // head and tail must be found at every position of the ring, before and after wrapping around (several times):
+  const uint16_t SLOTS = 37;
+  RAMStore store = RAMStore(sizeof(uint8_t) + sizeof(uint16_t) + SLOTS * sizeof(LogEntry)); 
+  TestLog logging = TestLog(&store);
+  logging.clear();
+  for (uint16_t i = 0; i < 3 * SLOTS + 5; i++) {
+    logging.logValues(i);
+    const uint16_t head = logging.logHeadIndex;
+    const uint16_t tail = logging.logTailIndex;
+    logging.logHeadIndex = 0;
+    logging.logTailIndex = 0;
+    logging.init();
+    assertEqual(logging.logHeadIndex, head);
+    assertEqual(logging.logTailIndex, tail);
+  }
+}
+
+test(h_log_checkpoint) {
+  const uint16_t SLOTS = 7;
+  const uint32_t LOG_SIZE = sizeof(uint8_t) + sizeof(uint16_t) + SLOTS * sizeof(LogEntry) + sizeof(LogCheckpoint);
+  RAMStore store = RAMStore(LOG_SIZE); 
+  TestLog logging = TestLog(&store, true);
+  assertEqual(logging.maxLogEntries(), SLOTS - 1u);
+  logging.clear();
+  for (int16_t i = 1; i <= 4; i++) {
+    logging.logValues(i);
+  }
+  LogEntry e;
+  logging.readUnnotifiedLogEntries();
+  assertEqual(logging.reader.toRead, 5u);
+  assertTrue(logging.nextLogEntry(e));
+  assertTrue(logging.nextLogEntry(e));
+  
+  // "board reset": the checkpoint restores the position of the unnotified reader
+  TestLog logging2 = TestLog(&store, true);
+  logging2.init();
+  assertEqual(logging2.logHeadIndex, logging.logHeadIndex);
+  assertEqual(logging2.logTailIndex, logging.logTailIndex);
+  logging2.readUnnotifiedLogEntries();
+  assertEqual(logging2.reader.toRead, 3u);
+  assertTrue(logging2.nextLogEntry(e));
+  LogValuesData lvd;
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 2);
+  
+  // a checkpoint that is behind the log (reset between writing the entry and the checkpoint) is detected by the timestamps:
+  const uint32_t cpOffset = LOG_SIZE - sizeof(LogCheckpoint);
+  LogCheckpoint cp;
+  store.read(cpOffset, cp);
+  logging2.logValues(9);
+  store.write(cpOffset, cp);
+  TestLog logging3 = TestLog(&store, true);
+  logging3.init();
+  assertEqual(logging3.logHeadIndex, logging2.logHeadIndex);
+  assertEqual(logging3.logTailIndex, logging2.logTailIndex);
+  
+  // corrupt checkpoint => fall back to the search; all entries count as notified
+  store.write8(cpOffset, store.read8(cpOffset) ^ 0x1);
+  TestLog logging4 = TestLog(&store, true);
+  logging4.init();
+  assertEqual(logging4.logHeadIndex, logging2.logHeadIndex);
+  assertEqual(logging4.logTailIndex, logging2.logTailIndex);
+  logging4.readUnnotifiedLogEntries();
+  assertEqual(logging4.reader.toRead, 0u);
+  
+  // (de)activating the checkpoint clears the log (a stale checkpoint is never used):
+  TestLog logging5 = TestLog(&store, false);
+  assertEqual(logging5.maxLogEntries(), logging4.maxLogEntries());  // same number of slots
+  logging5.init();
+  assertEqual(logging5.currentLogEntries(), 2u);  // LOG_INIT + LOG_MAGIC_NUMBER
+  logging5.logValues(10);
+  TestLog logging6 = TestLog(&store, true);
+  logging6.init();
+  assertEqual(logging6.currentLogEntries(), 2u);
+}
+
+test(i_log_batch) {
+  const uint16_t SLOTS = 10;
+  CountingRAMStore store = CountingRAMStore(sizeof(uint8_t) + sizeof(uint16_t) + SLOTS * sizeof(LogEntry)); 
+  TestLog logging = TestLog(&store);
+  logging.clear();
+  
+  store.bytesWritten = 0;
+  for (int16_t v = 1; v <= 4; v++) {
+    logging.logValues(v);
+  }
+  const uint32_t singleBytes = store.bytesWritten;
+  assertEqual(singleBytes, 8 * sizeof(LogEntry));  // 4 entries + 4 cleared slots
+  
+  store.bytesWritten = 0;
+  logging.beginBatch();
+  for (int16_t v = 5; v <= 8; v++) {
+    logging.logValues(v);
+  }
+  logging.commit();
+  assertEqual(store.bytesWritten, 5 * sizeof(LogEntry));  // 4 entries + 1 cleared slot
+  assertEqual(logging.currentLogEntries(), 9u);
+  assertEqual(store.read8(sizeof(uint8_t) + sizeof(uint16_t) + logging.logHeadIndex * sizeof(LogEntry)), 0);
+  
+  // appendBatch() wraps around like single entries:
+  LogEntry entries[3];
+  memset(entries, 0x0, sizeof(entries));
+  for (int16_t i = 0; i < 3; i++) {
+    entries[i].type = static_cast<T_LogDataType_ID>(LogDataType::VALUES);
+    int16_t v = 9 + i;
+    memcpy(&(entries[i].data), &v, sizeof(v));
+  }
+  logging.appendBatch(entries, 3);
+  assertEqual(logging.currentLogEntries(), SLOTS - 1u);
+  assertEqual(logging.logHeadIndex, 2u);
+  assertEqual(logging.logTailIndex, 3u);
+  logging.readMostRecentLogEntries(0);
+  LogEntry e;
+  LogValuesData lvd;
+  for (int16_t v = 11; v >= 3; v--) {
+    assertTrue(logging.nextLogEntry(e));
+    memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+    assertEqual(lvd.value, v);
+  }
+  
+  // board reset during a batch: the entries written so far are found by init()
+  logging.beginBatch();
+  for (int16_t v = 12; v <= 19; v++) {
+    logging.logValues(v);  // ends in the last slot => no empty slot left
+  }
+  TestLog logging2 = TestLog(&store);
+  logging2.init();
+  assertEqual(logging2.logHeadIndex, 0u);
+  assertEqual(logging2.logTailIndex, 1u);
+  logging2.readMostRecentLogEntries(1);
+  assertTrue(logging2.nextLogEntry(e));
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 19);
+}
+
+test(j_log_cursors) {
+  RAMStore store = RAMStore(STORE_SIZE); 
+  TestLog logging = TestLog(&store);
+  logging.clear(); // => creates a first log entry
+  logging.logValues(3000);
+  logging.logValues(3100);
+  
+  LogCursor recent;
+  LogCursor unnotified;
+  LogEntry e;
+  LogValuesData lvd;
+  logging.readMostRecentLogEntries(recent, 2);
+  logging.readUnnotifiedLogEntries(unnotified);
+  assertEqual(unnotified.toRead, 3u);
+  assertTrue(logging.nextLogEntry(unnotified, e));  // LOG_INIT message
+  assertEqual(int(e.type), int(static_cast<T_LogDataType_ID>(LogDataType::MESSAGE)));
+  
+  // cursors remain valid while entries are added:
+  logging.logValues(3200);
+  assertTrue(logging.nextLogEntry(recent, e));
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 3100);
+  assertTrue(logging.nextLogEntry(unnotified, e));
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 3000);
+  assertTrue(logging.nextLogEntry(recent, e));
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 3000);
+  assertFalse(logging.nextLogEntry(recent, e));
+  assertTrue(recent.valid);
+  
+  // the unnotified cursor also returns the entries added after it was initialised:
+  assertTrue(logging.nextLogEntry(unnotified, e));
+  assertTrue(logging.nextLogEntry(unnotified, e));
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 3200);
+  assertFalse(logging.nextLogEntry(unnotified, e));
+  assertTrue(unnotified.valid);
+  logging.logValues(3300);
+  assertTrue(logging.nextLogEntry(unnotified, e));
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 3300);
+  
+  // a cursor whose position has been overwritten is invalidated:
+  logging.readMostRecentLogEntries(recent, 0);
+  assertTrue(logging.nextLogEntry(recent, e));
+  assertEqual(recent.toRead, 4u);
+  logging.logValues(3400);
+  assertTrue(logging.nextLogEntry(recent, e));  // entry 3200 is still there
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 3200);
+  logging.logValues(3500);
+  assertFalse(logging.nextLogEntry(recent, e));  // entry 3100 was overwritten
+  assertFalse(recent.valid);
+  
+  // the unnotified cursor was not affected; clear() invalidates all cursors:
+  assertTrue(logging.nextLogEntry(unnotified, e));
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 3400);
+  logging.clear();
+  assertFalse(logging.nextLogEntry(unnotified, e));
+  assertFalse(unnotified.valid);
+}
+
+test(j_log_seq_wrap) {
+  const uint16_t SLOTS = 10;
+  RAMStore store = RAMStore(sizeof(uint8_t) + sizeof(uint16_t) + SLOTS * sizeof(LogEntry)); 
+  TestLog logging = TestLog(&store);
+  logging.clear();
+  logging.shiftSeq(0xFFFFFFFFul - 5 - logging.head());  // the sequence numbers wrap around after 5 more entries
+  
+  LogCursor unnotified;
+  logging.readUnnotifiedLogEntries(unnotified);
+  LogEntry e;
+  LogValuesData lvd;
+  assertTrue(logging.nextLogEntry(unnotified, e));  // M (clear)
+  Timestamp ts[13];
+  for (int16_t v = 1; v <= 12; v++) {
+    ts[v] = logging.logValues(v);
+  }
+  assertLess(logging.head(), 10ul);  // wrapped
+  
+  // the cursor initialised before the wrap-around was overwritten:
+  assertFalse(logging.nextLogEntry(unnotified, e));
+  assertFalse(unnotified.valid);
+  
+  logging.readUnnotifiedLogEntries(unnotified);
+  assertEqual(unnotified.toRead, 9u);
+  for (int16_t v = 4; v <= 12; v++) {
+    assertTrue(logging.nextLogEntry(unnotified, e));
+    memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+    assertEqual(lvd.value, v);
+  }
+  assertFalse(logging.nextLogEntry(unnotified, e));
+  assertTrue(unnotified.valid);
+  
+  LogCursor cursor;
+  logging.readRange(cursor, ts[5], ts[8]);
+  assertEqual(cursor.toRead, 4u);
+  LogEntry entries[4];
+  assertEqual(logging.nextLogEntries(cursor, entries, 4), 4u);
+  memcpy(&lvd, &(entries[3].data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 8);
+  
+  logging.readMostRecentLogEntries(cursor, 0);
+  assertEqual(logging.nextLogEntries(cursor, entries, 4), 4u);
+  memcpy(&lvd, &(entries[3].data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 9);
+}
+
+test(k_log_range) {
+  const uint16_t SLOTS = 10;
+  RAMStore store = RAMStore(sizeof(uint8_t) + sizeof(uint16_t) + SLOTS * sizeof(LogEntry)); 
+  TestLog logging = TestLog(&store);
+  logging.clear();
+  
+  Timestamp ts[13];
+  for (int16_t v = 1; v <= 12; v++) {
+    ts[v] = logging.logValues(v);
+    if (v % 3 == 0) logging.logMessage(static_cast<T_Message_ID>(ACF_Msg::LOG_INIT), v, 0);
+  }
+  // the log has wrapped around => M6 V7 V8 V9 M9 V10 V11 V12 M12
+  
+  LogCursor cursor;
+  LogEntry e;
+  LogValuesData lvd;
+  LogMessageData lmd;
+  logging.readRange(cursor, ts[8], ts[11], LOG_TYPE_MASK(static_cast<T_LogDataType_ID>(LogDataType::VALUES)));
+  assertEqual(cursor.toRead, 5u);
+  for (int16_t v = 8; v <= 11; v++) {
+    assertTrue(logging.nextLogEntry(cursor, e));
+    memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+    assertEqual(lvd.value, v);
+  }
+  assertFalse(logging.nextLogEntry(cursor, e));
+  assertEqual(cursor.read, 4u);
+  
+  logging.readRange(cursor, 0, 0xFFFFFFFF, LOG_TYPE_MASK(static_cast<T_LogDataType_ID>(LogDataType::MESSAGE)));
+  assertEqual(cursor.toRead, 9u);
+  for (int16_t v = 6; v <= 12; v += 3) {
+    assertTrue(logging.nextLogEntry(cursor, e));
+    memcpy(&lmd, &(e.data), sizeof(LogMessageData));
+    assertEqual(lmd.params[0], v);
+  }
+  assertFalse(logging.nextLogEntry(cursor, e));
+  
+  // overwritten entries are not returned:
+  logging.readRange(cursor, ts[2], ts[7]);
+  assertEqual(cursor.toRead, 2u);
+  assertTrue(logging.nextLogEntry(cursor, e));
+  assertEqual(int(e.type), int(static_cast<T_LogDataType_ID>(LogDataType::MESSAGE)));
+  assertTrue(logging.nextLogEntry(cursor, e));
+  assertEqual(e.timestamp, ts[7]);
+  assertFalse(logging.nextLogEntry(cursor, e));
+  
+  logging.readRange(cursor, ts[12] + 1, 0xFFFFFFFF);
+  assertEqual(cursor.toRead, 1u);  // M12
+  logging.readRange(cursor, ts[11], ts[10]);
+  assertEqual(cursor.toRead, 0u);
+  assertFalse(logging.nextLogEntry(cursor, e));
+  
+  // types >= 32 can't be filtered: they only match LOG_TYPE_MASK_ALL
+  assertEqual(LOG_TYPE_MASK(31), 0x80000000ul);
+  assertEqual(LOG_TYPE_MASK(200), 0ul);
+  logging.clear();
+  logging.logValues(1);
+  logging.logType(200);
+  logging.logValues(2);
+  logging.readRange(cursor, 0, 0xFFFFFFFF, LOG_TYPE_MASK(static_cast<T_LogDataType_ID>(LogDataType::VALUES)));
+  assertTrue(logging.nextLogEntry(cursor, e));
+  assertTrue(logging.nextLogEntry(cursor, e));
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 2);
+  assertFalse(logging.nextLogEntry(cursor, e));
+  logging.readRange(cursor, 0, 0xFFFFFFFF);
+  assertEqual(cursor.toRead, 4u);  // M (clear) V1 T200 V2
+  assertTrue(logging.nextLogEntry(cursor, e));
+  assertTrue(logging.nextLogEntry(cursor, e));
+  assertTrue(logging.nextLogEntry(cursor, e));
+  assertEqual(int(e.type), 200);
+}
+
+test(l_log_index) {
+  const uint16_t SLOTS = 40;
+  CountingRAMStore store = CountingRAMStore(sizeof(uint8_t) + sizeof(uint16_t) + SLOTS * sizeof(LogEntry)); 
+  TestLog logging = TestLog(&store);
+  logging.clear();
+  Timestamp ts[61];
+  for (int16_t v = 1; v <= 60; v++) {
+    ts[v] = logging.logValues(v);
+  }
+  
+  Timestamp buffer[8];
+  TestLog indexed = TestLog(&store);
+  indexed.setIndex(buffer, 8);  // => every 5th slot
+  indexed.init();
+  
+  LogCursor cursor;
+  LogEntry e;
+  LogValuesData lvd;
+  store.reads = 0;
+  logging.readRange(cursor, ts[30], ts[40]);
+  const uint32_t searchReads = store.reads;
+  assertEqual(cursor.toRead, 11u);
+  store.reads = 0;
+  indexed.readRange(cursor, ts[30], ts[40]);
+  assertLess(store.reads, searchReads);
+  assertLessOrEqual(store.reads, 6u);  // 2 x log2(5)
+  assertEqual(cursor.toRead, 11u);
+  assertTrue(indexed.nextLogEntry(cursor, e));
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 30);
+  
+  // the index is maintained when entries are added:
+  for (int16_t v = 61; v <= 80; v++) {
+    indexed.logValues(v);
+  }
+  for (int16_t v = 42; v <= 80; v += 7) {
+    LogCursor recent;
+    indexed.readMostRecentLogEntries(recent, 81 - v);
+    while (indexed.nextLogEntry(recent, e)) ;
+    Timestamp from = e.timestamp;
+    indexed.readRange(cursor, from, from);
+    assertEqual(cursor.toRead, 1u);
+    assertTrue(indexed.nextLogEntry(cursor, e));
+    memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+    assertEqual(lvd.value, v);
+  }
+}
+
+test(m_log_precise) {
+  const uint16_t SLOTS = 120;
+  RAMStore store = RAMStore(sizeof(uint8_t) + sizeof(uint16_t) + SLOTS * sizeof(PreciseLogEntry)); 
+  TestPreciseLog logging = TestPreciseLog(&store);
+  logging.clear();
+  
+  // 100 entries within a few milliseconds, without delay():
+  const uint32_t ms = millis();
+  PreciseTimestamp ts[101];
+  ts[0] = 0;
+  for (int16_t v = 1; v <= 100; v++) {
+    ts[v] = logging.logValues(v);
+    assertMore(ts[v], ts[v - 1]);
+  }
+  assertLess(millis() - ms, 500ul);
+  assertEqual(logging.currentLogEntries(), 101u);
+  
+  LogCursor cursor;
+  PreciseLogEntry e;
+  LogValuesData lvd;
+  logging.readRange(cursor, ts[40], ts[49]);
+  assertEqual(cursor.toRead, 10u);
+  assertTrue(logging.nextLogEntry(cursor, e));
+  assertEqual(e.timestamp, ts[40]);
+  memcpy(&lvd, &(e.data), sizeof(LogValuesData));
+  assertEqual(lvd.value, 40);
+  
+  // board reset: the timestamps continue to ascend
+  TestPreciseLog logging2 = TestPreciseLog(&store);
+  logging2.init();
+  assertEqual(logging2.currentLogEntries(), 101u);
+  assertMore(logging2.logValues(101), ts[100]);
+  
+  // a log with the other entry layout clears the log:
+  TestLog logging3 = TestLog(&store);
+  logging3.init();
+  assertEqual(logging3.currentLogEntries(), 2u);  // LOG_INIT + LOG_MAGIC_NUMBER
+}
+
 test(z_s_o_s) {
   S_O_S(F("Program execution halted, S.O.S. Verify line number with test-code"));
-}
\ No newline at end of file
+}
@@ -182,3 +182,208 @@ test(f_illegal_trans) {
   assertEqual(automaton.state()->id().id(), STATE_A.id());
   assertEqual(automaton.state()->illegalTransitionLogged.events(), EVENT_C_D.id());
 }
+
+test(g_state_clock) {
+  MockExecutionContext context = MockExecutionContext();
+  FakeClock clock = FakeClock(0xFFFFFFFFull - 100);  // 100 ms before millis() overflows
+  TestAutomaton automaton = TestAutomaton();
+  automaton.setClock(&clock);
+  automaton.init(&context);
+  assertEqual(automaton.inStateMillis(), 0ul);
+  clock.advance(1000);
+  assertEqual(automaton.inStateMillis(), 1000ul);
+  
+  automaton.transition(EVENT_A_B);
+  assertEqual(automaton.inStateMillis(), 0ul);
+  clock.advance(30ull * 24 * 3600 * 1000);  // 30 days
+  assertEqual(automaton.inStateMillis(), 30ul * 24 * 3600 * 1000);
+}
+
+test(h_state_lookup) {
+  MockExecutionContext context = MockExecutionContext();
+  TestAutomaton automaton = TestAutomaton();
+  automaton.init(&context);
+  assertEqual(automaton.lookup(STATE_A)->id().id(), STATE_A.id());
+  assertEqual(automaton.lookup(STATE_C)->id().id(), STATE_C.id());
+  assertEqual(automaton.lookup(STATE_E)->id().id(), STATE_E.id());
+  
+  automaton.transition(EVENT_A_B);
+  automaton.transition(EVENT_C_D);
+  assertTrue(automaton.state() == automaton.lookup(STATE_D));
+}
+
+test(i_nested_transitions) {
+  NestedAutomaton automaton = NestedAutomaton();
+  automaton.init();
+  NestedContext &context = automaton.context;
+  
+  // K -> F (-> ends up at G's initial substate H):
+  automaton.transition(Event(STATE_F.id()));
+  assertEqual(automaton.state()->id().id(), STATE_H.id());
+  assertEqual(automaton.state()->depth, 2);
+  assertEqual(context.exits[STATE_K.id()], 1);
+  assertEqual(context.entries[STATE_F.id()], 1);
+  assertEqual(context.entries[STATE_G.id()], 1);
+  assertEqual(context.entries[STATE_H.id()], 1);
+  assertEqual(context.total(), 4);
+  
+  // H -> J: leaves G but not F
+  context.reset();
+  automaton.transition(Event(STATE_J.id()));
+  assertEqual(automaton.state()->id().id(), STATE_J.id());
+  assertEqual(context.exits[STATE_H.id()], 1);
+  assertEqual(context.exits[STATE_G.id()], 1);
+  assertEqual(context.entries[STATE_J.id()], 1);
+  assertEqual(context.total(), 3);
+  
+  // J -> I: a nested descendant of F => F is neither exited nor entered, but G is entered
+  context.reset();
+  automaton.transition(Event(STATE_I.id()));
+  assertEqual(automaton.state()->id().id(), STATE_I.id());
+  assertEqual(context.exits[STATE_J.id()], 1);
+  assertEqual(context.entries[STATE_G.id()], 1);
+  assertEqual(context.entries[STATE_I.id()], 1);
+  assertEqual(context.total(), 3);
+  
+  // I -> G: to a containing state => G is exited and re-entered
+  context.reset();
+  automaton.transition(Event(STATE_G.id()));
+  assertEqual(automaton.state()->id().id(), STATE_H.id());
+  assertEqual(context.exits[STATE_I.id()], 1);
+  assertEqual(context.exits[STATE_G.id()], 1);
+  assertEqual(context.entries[STATE_G.id()], 1);
+  assertEqual(context.entries[STATE_H.id()], 1);
+  assertEqual(context.total(), 4);
+  
+  // H -> K: leaves G and F
+  context.reset();
+  automaton.transition(Event(STATE_K.id()));
+  assertEqual(automaton.state()->id().id(), STATE_K.id());
+  assertEqual(context.exits[STATE_H.id()], 1);
+  assertEqual(context.exits[STATE_G.id()], 1);
+  assertEqual(context.exits[STATE_F.id()], 1);
+  assertEqual(context.entries[STATE_K.id()], 1);
+  assertEqual(context.total(), 4);
+}
+
+test(j_table_states) {
+  MockExecutionContext context = MockExecutionContext();
+  TableAutomaton automaton = TableAutomaton(&context);
+  assertEqual(automaton.state()->id().id(), STATE_A.id());
+  
+  // A -> B (-> C) with transition action:
+  automaton.transition(EVENT_A_B);
+  assertEqual(automaton.state()->id().id(), STATE_C.id());
+  assertEqual(context.transAction_A_B, 1);
+  
+  // C -> C: same state, transition action only
+  automaton.transition(EVENT_C_C);
+  assertEqual(automaton.state()->id().id(), STATE_C.id());
+  assertEqual(context.transAction_C_C, 1);
+  
+  automaton.transition(EVENT_C_D);
+  assertEqual(automaton.state()->id().id(), STATE_D.id());
+  
+  // not in the rows of D => handled by the containing state B:
+  automaton.transition(EVENT_B_A);
+  assertEqual(automaton.state()->id().id(), STATE_A.id());
+  
+  // not in the table at all:
+  automaton.transition(EVENT_D_E);
+  assertEqual(automaton.state()->id().id(), STATE_A.id());
+  assertEqual(automaton.state()->illegalTransitionLogged.events(), EVENT_D_E.id());
+}
+
+test(k_event_queue) {
+  T_Event_ID buffer[4];
+  EventQueue queue = EventQueue(buffer, 4);  // holds 3 events
+  assertEqual(queue.size(), 0);
+  assertTrue(queue.put(EVENT_A_B));
+  assertTrue(queue.put(EVENT_C_D));
+  assertTrue(queue.put(EVENT_D_E));
+  assertFalse(queue.put(EVENT_B_A));
+  assertEqual(queue.size(), 3);
+  assertEqual(queue.overflows(), 1);
+  
+  T_Event_ID event;
+  assertTrue(queue.get(event));
+  assertEqual(event, EVENT_A_B.id());
+  // wrap around:
+  assertTrue(queue.put(EVENT_B_A));
+  assertEqual(queue.size(), 3);
+  assertTrue(queue.get(event));
+  assertEqual(event, EVENT_C_D.id());
+  assertTrue(queue.get(event));
+  assertEqual(event, EVENT_D_E.id());
+  assertTrue(queue.get(event));
+  assertEqual(event, EVENT_B_A.id());
+  assertFalse(queue.get(event));
+  assertEqual(queue.size(), 0);
+}
+
+test(l_dispatch_pending) {
+  T_Event_ID buffer[4];
+  EventQueue queue = EventQueue(buffer, 4);
+  QueueAutomaton automaton = QueueAutomaton(&queue);
+  assertEqual(automaton.state()->id().id(), STATE_A.id());
+  
+  // the action of A -> B posts C -> D, which is processed after B (and C) have been entered.
+  // Note: actions and ISRs may post to the same queue (put() is a critical section); only dispatchPending() takes events.
+  assertTrue(automaton.post(EVENT_A_B));
+  assertEqual(automaton.dispatchPending(), 2);
+  assertEqual(automaton.state()->id().id(), STATE_D.id());
+  assertEqual(queue.size(), 0);
+  
+  // limited number of events per call:
+  automaton.post(EVENT_B_A);
+  automaton.post(EVENT_A_B);
+  assertEqual(automaton.dispatchPending(1), 1);
+  assertEqual(automaton.state()->id().id(), STATE_A.id());
+  assertEqual(automaton.dispatchPending(1), 1);
+  assertEqual(automaton.state()->id().id(), STATE_C.id());
+  assertEqual(automaton.dispatchPending(), 1);  // posted by the action
+  assertEqual(automaton.state()->id().id(), STATE_D.id());
+  assertEqual(automaton.dispatchPending(), 0);
+}
+
+test(m_timeouts) {
+  MockExecutionContext context = MockExecutionContext();
+  FakeClock clock = FakeClock(1000);
+  TestAutomaton automaton = TestAutomaton();
+  automaton.setClock(&clock);
+  automaton.init(&context);
+  StateDeadline deadlines[NUM_TIMEOUTS];
+  automaton.setTimeouts(TIMEOUTS, NUM_TIMEOUTS, deadlines);
+  assertEqual(automaton.millisUntilNextDeadline(), NO_DEADLINE);  // no timeouts at A
+  
+  // A -> B (-> C) arms the timeouts of B and C:
+  automaton.transition(EVENT_A_B);
+  assertEqual(automaton.millisUntilNextDeadline(), C_C_TIMEOUT);
+  clock.advance(C_C_TIMEOUT - 1);
+  assertEqual(automaton.processTimeouts(), 0);
+  assertEqual(automaton.millisUntilNextDeadline(), 1ul);
+  clock.advance(1);
+  assertEqual(automaton.processTimeouts(), 1);
+  assertEqual(context.transAction_C_C, 1);
+  assertEqual(automaton.state()->id().id(), STATE_C.id());
+  
+  // fires once per entry; B's timeout keeps running within B:
+  assertEqual(automaton.millisUntilNextDeadline(), B_A_TIMEOUT - C_C_TIMEOUT);
+  automaton.transition(EVENT_C_D);
+  assertEqual(automaton.millisUntilNextDeadline(), B_A_TIMEOUT - C_C_TIMEOUT);
+  clock.advance(B_A_TIMEOUT);
+  assertEqual(automaton.millisUntilNextDeadline(), 0ul);
+  assertEqual(automaton.processTimeouts(), 1);
+  assertEqual(automaton.state()->id().id(), STATE_A.id());
+  assertEqual(automaton.millisUntilNextDeadline(), NO_DEADLINE);
+  
+  // exiting C before its timeout cancels it:
+  automaton.transition(EVENT_A_B);
+  automaton.transition(EVENT_C_D);
+  assertEqual(automaton.millisUntilNextDeadline(), B_A_TIMEOUT);
+  automaton.transition(EVENT_D_E);
+  assertEqual(automaton.millisUntilNextDeadline(), NO_DEADLINE);
+  clock.advance(B_A_TIMEOUT);
+  assertEqual(automaton.processTimeouts(), 0);
+  assertEqual(automaton.state()->id().id(), STATE_E.id());
+}
@@ -198,5 +198,171 @@
         b.setSubstates(B_SUBSTATES, 2);
         currentState = &a;  // just a example: is the default anyway
       }
+      
+      /* Exposes the lookup for tests. */
+      AbstractState *lookup(const StateID id) { return state(id); }
+  };
+  
+  //  +---------------------------------+
+  //  | F    +--------------------+     |
+  //  |      | G    +---+  +---+  |     |    +---+
+  //  |  o-->|  o-->| H |  | I |  |     |    | K |
+  //  |      |      +---+  +---+  |     |    +---+
+  //  |      +--------------------+     |
+  //  |                        +---+    |
+  //  |                        | J |    |
+  //  |                        +---+    |
+  //  +---------------------------------+
+  //
+  // Every event leads to the state whose ID equals the event ID.
+
+  static const uint8_t NUM_NESTED_STATES = 6;
+  static const StateID STATE_F = StateID(10);
+  static const StateID STATE_G = StateID(11);
+  static const StateID STATE_H = StateID(12);
+  static const StateID STATE_I = StateID(13);
+  static const StateID STATE_J = StateID(14);
+  static const StateID STATE_K = StateID(MAX_STATE_ID);  // highest possible state ID
+  
+  /* Counts entry and exit actions per state. */
+  class NestedContext {
+    public:
+      uint16_t entries[MAX_STATE_ID + 1];
+      uint16_t exits[MAX_STATE_ID + 1];
+      NestedContext() { reset(); }
+      void reset() {
+        memset(entries, 0, sizeof(entries));
+        memset(exits, 0, sizeof(exits));
+      }
+      uint16_t total() {
+        uint16_t sum = 0;
+        for (uint8_t i = 0; i <= MAX_STATE_ID; i++) sum += entries[i] + exits[i];
+        return sum;
+      }
+  };
+  
+  class NestedSimpleState : public AbstractSimpleState {
+    public:
+      NestedSimpleState(const StateID stateID, NestedContext *context) : stateID(stateID) { this->context = context; }
+      StateID id() { return stateID; }
+      StateID transAction(const Event event) { return StateID(event.id()); }
+      void entryAction() { context->entries[stateID.id()]++; }
+      void exitAction()  { context->exits[stateID.id()]++; }
+    protected:
+      const StateID stateID;
+      NestedContext *context;
+  };
+  
+  class NestedCompositeState : public AbstractCompositeState {
+    public:
+      NestedCompositeState(const StateID stateID, NestedContext *context) : stateID(stateID) { this->context = context; }
+      StateID id() { return stateID; }
+      void entryAction() { context->entries[stateID.id()]++; }
+      void exitAction()  { context->exits[stateID.id()]++; }
+    protected:
+      const StateID stateID;
+      NestedContext *context;
+  };
+  
+  class NestedAutomaton : public AbstractStateAutomaton {
+    public:
+      NestedContext context;
+    private:
+      NestedCompositeState f = NestedCompositeState(STATE_F, &context);
+      NestedCompositeState g = NestedCompositeState(STATE_G, &context);
+      NestedSimpleState h = NestedSimpleState(STATE_H, &context);
+      NestedSimpleState i = NestedSimpleState(STATE_I, &context);
+      NestedSimpleState j = NestedSimpleState(STATE_J, &context);
+      NestedSimpleState k = NestedSimpleState(STATE_K, &context);
+      AbstractState *G_SUBSTATES[2] = {&h, &i};
+      AbstractState *F_SUBSTATES[2] = {&g, &j};
+      AbstractState *ALL_STATES[NUM_NESTED_STATES] = {&f, &g, &h, &i, &j, &k};
+  
+   public:
+      void init() {
+        // inner composite state first: the depths are propagated when G is added to F
+        g.setSubstates(G_SUBSTATES, 2);
+        f.setSubstates(F_SUBSTATES, 2);
+        setStates(ALL_STATES, NUM_NESTED_STATES, &k);
+      }
+  };
+  
+  // The A..E automaton from above, defined by a transition table:
+  
+  static void tableTrans_A_B(void *context) { ((MockExecutionContext *) context)->trans_A_B(); }
+  static void tableTrans_C_C(void *context) { ((MockExecutionContext *) context)->trans_C_C(); }
+  
+  static const TransitionRow TRANSITIONS[] PROGMEM = {
+    {STATE_A.id(), EVENT_A_B.id(), STATE_B.id(), &tableTrans_A_B},
+    {STATE_B.id(), EVENT_B_A.id(), STATE_A.id(), NULL},
+    {STATE_C.id(), EVENT_C_C.id(), STATE_C.id(), &tableTrans_C_C},
+    {STATE_C.id(), EVENT_C_D.id(), STATE_D.id(), NULL},
+    {STATE_D.id(), EVENT_D_E.id(), STATE_E.id(), NULL},
+  };
+  static const uint16_t NUM_TRANSITIONS = sizeof(TRANSITIONS) / sizeof(TransitionRow);
+  
+  class TableAutomaton : public AbstractStateAutomaton {
+    public:
+      TableAutomaton(MockExecutionContext *context) : 
+        a(STATE_A, TRANSITIONS, NUM_TRANSITIONS, context),
+        b(STATE_B, TRANSITIONS, NUM_TRANSITIONS, context),
+        c(STATE_C, TRANSITIONS, NUM_TRANSITIONS, context),
+        d(STATE_D, TRANSITIONS, NUM_TRANSITIONS, context),
+        e(STATE_E, TRANSITIONS, NUM_TRANSITIONS, context) {
+        b.setSubstates(B_SUBSTATES, 2);
+        setStates(ALL_STATES, NUM_STATES);
+      }
+    private:
+      TableState a;
+      TableCompositeState b;
+      TableState c;
+      TableState d;
+      TableState e;
+      AbstractState *B_SUBSTATES[2] = {&c, &d};
+      AbstractState *ALL_STATES[NUM_STATES] = {&a, &b, &c, &d, &e};
+  };
+  
+  // The A..E automaton with a transition action posting an event (the context is the automaton):
+  
+  static void tablePost_C_D(void *context) { ((AbstractStateAutomaton *) context)->post(EVENT_C_D); }
+  
+  static const TransitionRow POSTING_TRANSITIONS[] PROGMEM = {
+    {STATE_A.id(), EVENT_A_B.id(), STATE_B.id(), &tablePost_C_D},
+    {STATE_B.id(), EVENT_B_A.id(), STATE_A.id(), NULL},
+    {STATE_C.id(), EVENT_C_D.id(), STATE_D.id(), NULL},
+    {STATE_D.id(), EVENT_D_E.id(), STATE_E.id(), NULL},
+  };
+  static const uint16_t NUM_POSTING_TRANSITIONS = sizeof(POSTING_TRANSITIONS) / sizeof(TransitionRow);
+  
+  class QueueAutomaton : public AbstractStateAutomaton {
+    public:
+      QueueAutomaton(EventQueue *queue) : 
+        a(STATE_A, POSTING_TRANSITIONS, NUM_POSTING_TRANSITIONS, this),
+        b(STATE_B, POSTING_TRANSITIONS, NUM_POSTING_TRANSITIONS, this),
+        c(STATE_C, POSTING_TRANSITIONS, NUM_POSTING_TRANSITIONS, this),
+        d(STATE_D, POSTING_TRANSITIONS, NUM_POSTING_TRANSITIONS, this),
+        e(STATE_E, POSTING_TRANSITIONS, NUM_POSTING_TRANSITIONS, this) {
+        b.setSubstates(B_SUBSTATES, 2);
+        setStates(ALL_STATES, NUM_STATES);
+        setEventQueue(queue);
+      }
+    private:
+      TableState a;
+      TableCompositeState b;
+      TableState c;
+      TableState d;
+      TableState e;
+      AbstractState *B_SUBSTATES[2] = {&c, &d};
+      AbstractState *ALL_STATES[NUM_STATES] = {&a, &b, &c, &d, &e};
+  };
+  
+  // Timeouts of the A..E automaton: C -> C like C::eval(), and out of B after a while
+  
+  static const TimeMillis B_A_TIMEOUT = 5000L;
+  
+  static const StateTimeout TIMEOUTS[] PROGMEM = {
+    {STATE_C.id(), EVENT_C_C.id(), C_C_TIMEOUT},
+    {STATE_B.id(), EVENT_B_A.id(), B_A_TIMEOUT},
   };
+  static const uint8_t NUM_TIMEOUTS = sizeof(TIMEOUTS) / sizeof(StateTimeout);
 #endif
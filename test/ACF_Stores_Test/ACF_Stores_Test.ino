@@ -5,8 +5,15 @@
 #include <ACF_Store.h>
 #if not defined(ARDUINO_SAMD_ZERO) && not defined(ARDUINO_SAMD_MKR1000)
   #include <ACF_EEPROM.h>
+  #include <ACF_WearLevelledEEPROM.h>
 #endif
 #include <ACF_FRAM.h>
+#include <ACF_CachedStore.h>
+#if !defined(ARDUINO)
+  #include <ACF_MMapFile.h>
+  #include <fcntl.h>
+  #include <unistd.h>
+#endif
 
 //#define DEBUG_UT_LOGGING
 
@@ -91,6 +98,219 @@ test(d_FRAM) {
   check(&store2, 222);
 }
 
+#if !defined(ARDUINO)
+// Host build only: counts the traffic on the mock I2C bus of extras/host/Wire.h
+test(e_FRAM_burst) {
+  const uint32_t BURST_SIZE = 256;
+  FRAMStore store1 = FRAMStore(STORE_OFFSET, STORE_SIZE);
+  assertTrue(store1.init());
+  Wire.resetCounters();
+  readWrite(&store1);
+  assertLessOrEqual(Wire.maxData, FRAM_READ_CHUNK_SIZE);
+  assertEqual(Wire.dropped, 0u);
+  
+  FRAMStore store2 = FRAMStore(&store1, BURST_SIZE);
+  
+  // clear: byte-wise vs. burst (every write transaction: device address + memory address (2) + data)
+  Wire.resetCounters();
+  for (uint32_t i=0; i<BURST_SIZE; i++) store2.write8(i, 0x0);
+  const uint32_t byteWiseWrite = Wire.busBytes;
+  Wire.resetCounters();
+  store2.clear();
+  assertEqual(Wire.transactions, (BURST_SIZE + FRAM_WRITE_CHUNK_SIZE - 1) / FRAM_WRITE_CHUNK_SIZE);
+  assertEqual(Wire.maxData, FRAM_WRITE_CHUNK_SIZE);
+  assertEqual(Wire.dropped, 0u);
+  assertMoreOrEqual(byteWiseWrite, 3 * Wire.busBytes);
+  
+  // full scan: byte-wise vs. burst (every read: addressing write + read)
+  uint8_t buf[BURST_SIZE];
+  Wire.resetCounters();
+  for (uint32_t i=0; i<BURST_SIZE; i++) buf[i] = store2.read8(i);
+  const uint32_t byteWiseRead = Wire.busBytes;
+  Wire.resetCounters();
+  store2.readBlock(0, buf, BURST_SIZE);
+  assertEqual(Wire.transactions, 2 * ((BURST_SIZE + FRAM_READ_CHUNK_SIZE - 1) / FRAM_READ_CHUNK_SIZE));
+  assertEqual(Wire.maxData, FRAM_READ_CHUNK_SIZE);
+  assertEqual(Wire.dropped, 0u);
+  assertMoreOrEqual(byteWiseRead, 3 * Wire.busBytes);
+  
+  // block write with chunks spanning the (unaligned) start:
+  for (uint32_t i=0; i<BURST_SIZE; i++) buf[i] = i;
+  Wire.resetCounters();
+  store2.writeBlock(3, buf, BURST_SIZE - 3);
+  assertEqual(Wire.dropped, 0u);
+  for (uint32_t i=3; i<BURST_SIZE; i++) assertEqual(Wire.fram[STORE_OFFSET + STORE_SIZE + i], buf[i - 3]);
+  
+  // no interference with the predecessor store:
+  fill(&store1, 111);
+  check(&store1, 111);
+  store2.readBlock(3, buf, BURST_SIZE - 3);
+  for (uint32_t i=3; i<BURST_SIZE; i++) assertEqual(buf[i - 3], (uint8_t) (i - 3));
+}
+#endif
+
+test(f_cached) {
+  RAMStore backing = RAMStore(STORE_SIZE);
+  CachedStore store = CachedStore(&backing, 2, 4);
+  assertFalse(store.expiringMedia());
+  readWrite(&store);
+  
+  // writes are not visible on the underlying store before flush():
+  store.write8(IDX_A, 55);
+  store.write8(IDX_A + 1, 56);
+  assertEqual(store.read8(IDX_A), 55);
+  assertEqual(backing.read8(IDX_A), 0);
+  store.resetCounters();
+  store.flush();
+  assertEqual(store.flushes(), 1u);
+  assertEqual(backing.read8(IDX_A), 55);
+  assertEqual(backing.read8(IDX_A + 1), 56);
+  store.flush();
+  assertEqual(store.flushes(), 1u); // nothing dirty
+  
+  // LRU: page 0 stays cached while pages 1 and 2 compete for the other cache page
+  store.resetCounters();
+  store.read8(0);  // hit
+  store.read8(4);  // miss
+  store.read8(0);  // hit
+  store.read8(8);  // miss, evicts page 1
+  store.read8(0);  // hit
+  assertEqual(store.hits(), 3u);
+  assertEqual(store.misses(), 2u);
+  
+  // dirty pages are written back on eviction:
+  store.write8(9, 77);
+  store.read8(4);  // evicts page 2
+  store.read8(12);  // evicts page 0 
+  assertEqual(backing.read8(9), 77);
+}
+
+test(g_cached_direct_mapped) {
+  RAMStore backing = RAMStore(STORE_SIZE);
+  CachedStore store = CachedStore(&backing, 2, 4, CacheReplacement::DIRECT_MAPPED);
+  store.read8(0);  // miss, cache page 0
+  store.read8(4);  // miss, cache page 1
+  store.read8(8);  // miss, cache page 0
+  store.read8(4);  // hit
+  store.read8(0);  // miss
+  assertEqual(store.hits(), 1u);
+  assertEqual(store.misses(), 4u);
+  
+  readWrite(&store);
+}
+
+test(h_cached_EEPROM) {
+  #if defined(ARDUINO_SAMD_ZERO) || defined(ARDUINO_SAMD_MKR1000)
+    Serial.println(F("SAMD M0 board does not feature EEPROM -> fail"));
+    fail();
+  #else
+    EEPROMStore backing = EEPROMStore(STORE_OFFSET, STORE_SIZE);
+    CachedStore store = CachedStore(&backing, 1, STORE_SIZE);
+    assertTrue(store.expiringMedia());
+    readWrite(&store);
+    
+    // neighbouring writes merge into one write-back of the changed bytes only:
+    store.flush();
+    store.resetCounters();
+    store.update8(IDX_A, 1);
+    store.update(IDX_B, (uint32_t) 3000);
+    store.update8(IDX_A, 2);
+    assertEqual(backing.read8(IDX_A), 0);
+    store.flush();
+    assertEqual(store.flushes(), 1u);
+    assertEqual(store.misses(), 0u);
+    uint32_t b = 0;
+    backing.read(IDX_B, b);
+    assertEqual(b, 3000u);
+    assertEqual(backing.read8(IDX_A), 2);
+  #endif
+}
+
+test(i_wear_levelled_EEPROM) {
+  #if defined(ARDUINO_SAMD_ZERO) || defined(ARDUINO_SAMD_MKR1000)
+    Serial.println(F("SAMD M0 board does not feature EEPROM -> fail"));
+    fail();
+  #else
+    const uint8_t PAGE_SIZE = 4;
+    const uint16_t PHYSICAL_PAGES = 2 * ((STORE_SIZE + PAGE_SIZE - 1) / PAGE_SIZE);
+    EEPROM.write(STORE_OFFSET, 0x0);  // destroy magic number => format
+    WearLevelledEEPROMStore store = WearLevelledEEPROMStore(STORE_OFFSET, STORE_SIZE, PHYSICAL_PAGES, PAGE_SIZE, true);
+    store.init();
+    assertTrue(store.expiringMedia());
+    assertEqual(store.size(), STORE_SIZE);
+    store.setRotationInterval(1);  // rotate at every page write
+    readWrite(&store);
+    
+    // hammer on one cell:
+    const uint16_t WRITES = 200;
+    for (uint16_t i=1; i<=WRITES; i++) {
+      store.write8(IDX_A, i % 256);
+      assertEqual(store.read8(IDX_A), i % 256);
+    }
+    assertLess(store.maxPageWrites(), WRITES / 2);
+    store.write(IDX_B, (uint32_t) 4711);
+    
+    // reload from EEPROM: same contents and counters
+    WearLevelledEEPROMStore store2 = WearLevelledEEPROMStore(STORE_OFFSET, STORE_SIZE, PHYSICAL_PAGES, PAGE_SIZE, true);
+    store2.init();
+    assertEqual(store2.read8(IDX_A), WRITES % 256);
+    uint32_t b = 0;
+    store2.read(IDX_B, b);
+    assertEqual(b, 4711u);
+    assertEqual(store2.maxPageWrites(), store.maxPageWrites());
+    
+    // reset while writing the step counter: tear the newer copy (copies follow the magic number) => previous step, same contents
+    EEPROMStore raw = EEPROMStore(STORE_OFFSET, 1 + 4 * sizeof(uint32_t));
+    uint32_t steps0, steps1;
+    raw.read(1, steps0);
+    raw.read(1 + 2 * sizeof(uint32_t), steps1);
+    assertNotEqual(steps0, steps1);
+    const uint32_t torn = 1 + (steps0 > steps1 ? 0 : 2 * sizeof(uint32_t)) + 1;
+    raw.write8(torn, raw.read8(torn) + 1);
+    WearLevelledEEPROMStore store3 = WearLevelledEEPROMStore(STORE_OFFSET, STORE_SIZE, PHYSICAL_PAGES, PAGE_SIZE, true);
+    store3.init();
+    assertEqual(store3.read8(IDX_A), WRITES % 256);
+    b = 0;
+    store3.read(IDX_B, b);
+    assertEqual(b, 4711u);
+  #endif
+}
+
+test(j_mmap_file) {
+  #if defined(ARDUINO)
+    Serial.println(F("Memory-mapped files are only supported by host builds -> skip"));
+  #else
+    const char *PATH = "ACF_Stores_Test.mmap";
+    unlink(PATH);
+    MMapFileStore store1 = MMapFileStore(PATH, STORE_OFFSET, STORE_SIZE);
+    assertTrue(store1.init());
+    assertFalse(store1.expiringMedia());
+    readWrite(&store1);
+    fill(&store1, 111);
+    store1.write(IDX_B, (uint32_t) 4711);
+    store1.sync();
+    
+    // persistent across instances:
+    MMapFileStore store2 = MMapFileStore(PATH, STORE_OFFSET, STORE_SIZE, true);
+    assertTrue(store2.init());
+    assertTrue(store2.expiringMedia());
+    assertEqual(store2.read8(IDX_A), 111);
+    uint32_t b = 0;
+    store2.read(IDX_B, b);
+    assertEqual(b, 4711u);
+    unlink(PATH);
+    
+    // a failed init() releases the file descriptor (a character device cannot be truncated):
+    const int probe = open("/dev/null", O_RDWR);
+    close(probe);
+    MMapFileStore store3 = MMapFileStore("/dev/null", STORE_OFFSET, STORE_SIZE);
+    assertFalse(store3.init());
+    const int next = open("/dev/null", O_RDWR);
+    close(next);
+    assertEqual(next, probe);
+  #endif
+}
+
 
 void readWrite(AbstractStore *store) {
   uint8_t  a = 1;
@@ -166,6 +386,28 @@ void readWrite(AbstractStore *store) {
   assertTrue(updated);
   store->read(IDX_C, rc);
   assertEqual(c.id, rc.id);
+
+  //
+  // block:
+  //
+  uint8_t d[STORE_SIZE];
+  for (uint32_t i=0; i<STORE_SIZE; i++) d[i] = i + 10;
+  store->writeBlock(0, d, STORE_SIZE);
+  uint8_t rd[STORE_SIZE];
+  memset(rd, 0x0, STORE_SIZE);
+  store->readBlock(0, rd, STORE_SIZE);
+  for (uint32_t i=0; i<STORE_SIZE; i++) assertEqual(d[i], rd[i]);
+  
+  // update with same values
+  updated = store->updateBlock(0, d, STORE_SIZE);
+  assertFalse(updated);
+  
+  // update with one different value (partial block)
+  d[IDX_C] = 99;
+  updated = store->updateBlock(IDX_B, d + IDX_B, STORE_SIZE - IDX_B);
+  assertTrue(updated);
+  assertEqual(store->read8(IDX_C), 99);
+  assertEqual(store->read8(IDX_C - 1), d[IDX_C - 1]);
   
   clear(store);
 }